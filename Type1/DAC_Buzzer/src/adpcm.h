@@ -0,0 +1,39 @@
+#ifndef __VVC_ADPCM_H
+#define __VVC_ADPCM_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+
+// IMA-ADPCM clip, stored as one continuous block of 4-bit codes
+// with two codes per byte (low nibble first). These are normally
+// generated from WAV files by 'tools/wav2adpcm.py'.
+typedef struct {
+  // Compressed samples; ( ( len + 1 ) / 2 ) bytes.
+  const uint8_t *data;
+  // Number of samples.
+  uint32_t len;
+  // Sample rate which the clip was encoded at, in Hertz.
+  uint32_t rate;
+  // Decoder state at the start of the clip.
+  int16_t  pred;
+  uint8_t  index;
+} adpcm_clip_t;
+
+// IMA-ADPCM decoder state.
+typedef struct {
+  // Clip being played, or 0 if nothing is playing.
+  const adpcm_clip_t *clip;
+  // Index of the next sample in the clip.
+  uint32_t pos;
+  // Last decoded 16-bit sample, and the current step size index.
+  int32_t  pred;
+  int32_t  index;
+  // Restart from the beginning after the last sample if nonzero.
+  uint8_t  loop;
+} adpcm_t;
+
+void adpcm_start( adpcm_t *dec, const adpcm_clip_t *clip, uint8_t loop );
+size_t adpcm_fill( adpcm_t *dec, uint16_t *buf, size_t len );
+
+#endif
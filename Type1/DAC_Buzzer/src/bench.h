@@ -0,0 +1,66 @@
+#ifndef __VVC_BENCH_H
+#define __VVC_BENCH_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+
+// Vendor-provided device header file, for the core's counters.
+#if defined( VVC_F3 )
+  #include "stm32f3xx.h"
+#elif defined( VVC_F4 )
+  #include "stm32f4xx.h"
+#elif defined( VVC_G0 )
+  #include "stm32g0xx.h"
+#endif
+
+// Most kernels which can be recorded in the results table.
+#define BENCH_MAX ( 16 )
+
+// Timing results for one kernel, in core clock cycles.
+typedef struct {
+  const char *name;
+  uint32_t runs;
+  uint32_t last;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+} bench_t;
+
+// Results table, which can be read with a debugger.
+extern bench_t bench_results[ BENCH_MAX ];
+extern size_t  bench_num;
+// Cycles which the reset handler took to start 'main'. (This is
+// only measured on a real chip; the host simulator does not run
+// the reset handler, so it stays at 0 there)
+extern uint32_t boot_cycles;
+
+// Read the cycle counter. Cortex-M4 cores have a DWT cycle
+// counter; Cortex-M0+ cores do not, so SysTick counts down
+// from 2^24 instead, and kernels must take fewer cycles than
+// that. Host builds scale 'clock_gettime' to the core clock.
+#if defined( VVC_HOST )
+uint32_t bench_cycles( void );
+#define BENCH_MASK ( 0xFFFFFFFF )
+#elif ( __CORTEX_M >= 0x03U )
+static inline uint32_t bench_cycles( void ) {
+  return DWT->CYCCNT;
+}
+#define BENCH_MASK ( 0xFFFFFFFF )
+#else
+static inline uint32_t bench_cycles( void ) {
+  return ( 0x00FFFFFF - SysTick->VAL );
+}
+#define BENCH_MASK ( 0x00FFFFFF )
+#endif
+
+// Start timing a kernel; pass the result to 'bench_stop'.
+static inline uint32_t bench_start( void ) {
+  return bench_cycles();
+}
+
+void     bench_init( void );
+uint32_t bench_stop( const char *name, uint32_t start );
+void     bench_record( const char *name, uint32_t cycles );
+
+#endif
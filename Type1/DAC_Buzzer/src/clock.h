@@ -0,0 +1,28 @@
+#ifndef __VVC_CLOCK_H
+#define __VVC_CLOCK_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+
+// Highest core clock speed which 'clock_init' can reach on each
+// chip family, in Hertz. This is the rated maximum, except on F3
+// chips: the F303K8 is rated for 72MHz, but its PLL can only take
+// the internal oscillator divided by 2 ( 8MHz / 2 * 16 = 64MHz ).
+// (It has no 'HSI / PREDIV' PLL source, so 72MHz needs an
+// external crystal, which these examples do not use)
+#if defined( VVC_F3 )
+  #define CLOCK_MAX_HZ ( 64000000 )
+#elif defined( VVC_F4 )
+  #define CLOCK_MAX_HZ ( 100000000 )
+#elif defined( VVC_G0 )
+  #define CLOCK_MAX_HZ ( 64000000 )
+#endif
+
+uint32_t clock_init( uint32_t hz );
+uint32_t clock_apb1_hz( void );
+uint32_t clock_apb2_hz( void );
+uint32_t clock_tim_hz( void );
+uint32_t clock_spi_br( uint32_t pclk, uint32_t hz );
+
+#endif
@@ -0,0 +1,64 @@
+#include "dds.h"
+#include "sections.h"
+
+// Reset an oscillator to play a quiet sine wave at 0Hz,
+// for a DAC which is triggered 'rate' times per second.
+void dds_init( dds_t *dds, uint32_t rate ) {
+  dds->phase = 0;
+  dds->step  = 0;
+  dds->rate  = rate;
+  dds->amp   = 32;
+  dds->table = WAVE_SINE;
+}
+
+// Set the output frequency, in 16.16 fixed-point Hertz.
+// The step is rounded to the nearest count, so the error is
+// less than ( rate / 2^33 )Hz at exactly 'rate' samples per
+// second. ('rate_calc' rounds the timer's real rate to the
+// nearest Hertz, which adds up to ( 0.5 / rate ) of relative
+// error on top of that) The phase is not reset, so the pitch
+// can change at any time without a discontinuity.
+void dds_set_freq( dds_t *dds, uint32_t hz_q16 ) {
+  uint64_t step = ( ( uint64_t )hz_q16 << 16 ) + ( dds->rate / 2 );
+  dds->step = ( uint32_t )( step / dds->rate );
+}
+
+// Change the output sample rate, keeping the same frequency.
+void dds_set_rate( dds_t *dds, uint32_t rate ) {
+  uint64_t step = ( uint64_t )dds->step * dds->rate + ( rate / 2 );
+  dds->step = ( uint32_t )( step / rate );
+  dds->rate = rate;
+}
+
+// Write the next 'len' samples into a buffer of unsigned
+// 12-bit DAC values, centered on 2048.
+RAMFUNC void dds_fill( dds_t *dds, uint16_t *buf, size_t len ) {
+  uint32_t phase = dds->phase;
+  for ( size_t i = 0; i < len; ++i ) {
+    int32_t s = dds->table[ phase >> ( 32 - DDS_TABLE_BITS ) ];
+    buf[ i ] = ( uint16_t )( 2048 + ( ( s * dds->amp ) >> 8 ) );
+    phase += dds->step;
+  }
+  dds->phase = phase;
+}
+
+// Write the next 'len' samples from two oscillators into a
+// buffer of packed stereo DAC values, with the left sample in
+// bits [11:0] and the right sample in bits [27:16]. This is the
+// layout of the dual-channel 'DHR12RD' DAC register.
+RAMFUNC void dds_fill_stereo( dds_t *left, dds_t *right,
+                              uint32_t *buf, size_t len ) {
+  uint32_t phase_l = left->phase;
+  uint32_t phase_r = right->phase;
+  for ( size_t i = 0; i < len; ++i ) {
+    int32_t l = left->table[ phase_l >> ( 32 - DDS_TABLE_BITS ) ];
+    int32_t r = right->table[ phase_r >> ( 32 - DDS_TABLE_BITS ) ];
+    uint32_t l12 = ( uint32_t )( 2048 + ( ( l * left->amp ) >> 8 ) );
+    uint32_t r12 = ( uint32_t )( 2048 + ( ( r * right->amp ) >> 8 ) );
+    buf[ i ] = l12 | ( r12 << 16 );
+    phase_l += left->step;
+    phase_r += right->step;
+  }
+  left->phase  = phase_l;
+  right->phase = phase_r;
+}
@@ -0,0 +1,39 @@
+#ifndef __VVC_DDS_H
+#define __VVC_DDS_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+// Generated wavetables.
+#include "wavetables.h"
+
+// Number of wavetable entries, as a power of two.
+#define DDS_TABLE_BITS ( WAVE_TABLE_BITS )
+#define DDS_TABLE_LEN  ( WAVE_TABLE_LEN )
+
+// Convert a constant frequency in Hertz to 16.16 fixed-point.
+#define DDS_HZ( x ) ( ( uint32_t )( ( x ) * 65536.0 ) )
+
+// Direct digital synthesis oscillator state.
+typedef struct {
+  // 32-bit phase accumulator. The top 'DDS_TABLE_BITS' bits
+  // index the wavetable, so one full cycle is 2^32 counts.
+  uint32_t phase;
+  // Phase increment per output sample (the 'tuning word').
+  uint32_t step;
+  // Output sample rate, in Hertz.
+  uint32_t rate;
+  // Output volume, out of 256.
+  uint16_t amp;
+  // Wavetable, as signed 12-bit samples. ('WAVE_SINE' etc.)
+  const int16_t *table;
+} dds_t;
+
+void dds_init( dds_t *dds, uint32_t rate );
+void dds_set_freq( dds_t *dds, uint32_t hz_q16 );
+void dds_set_rate( dds_t *dds, uint32_t rate );
+void dds_fill( dds_t *dds, uint16_t *buf, size_t len );
+void dds_fill_stereo( dds_t *left, dds_t *right,
+                      uint32_t *buf, size_t len );
+
+#endif
@@ -0,0 +1,181 @@
+// Generated by tools/wav2adpcm.py from 'pluck.wav'; do not edit.
+#include "adpcm.h"
+
+// 4096 samples at 32000Hz, in 2048 bytes.
+static const uint8_t PLUCK_DATA[ 2048 ] = {
+  0x30, 0x44, 0x32, 0x33, 0x33, 0x24, 0x22, 0x22, 0x11, 0x00, 0x90, 0xB9,
+  0xCB, 0xCC, 0xBB, 0xAD, 0xCB, 0xBA, 0xBB, 0xBB, 0xCB, 0xAA, 0x9A, 0x9A,
+  0x9A, 0x99, 0x9A, 0xBA, 0xBC, 0xBD, 0xCD, 0xCB, 0xDB, 0xCB, 0xBB, 0xAD,
+  0xAC, 0xBB, 0xAC, 0xBB, 0xBB, 0xAC, 0xAA, 0x9B, 0xAA, 0xA9, 0x99, 0x9A,
+  0xB9, 0xBB, 0xBE, 0xCD, 0xDB, 0xCB, 0xBC, 0xBC, 0xBC, 0xBC, 0xBB, 0xBC,
+  0xBB, 0xAA, 0x9A, 0x19, 0x41, 0x54, 0x44, 0x34, 0x44, 0x53, 0x42, 0x33,
+  0x43, 0x43, 0x33, 0x43, 0x32, 0x33, 0x33, 0x32, 0x22, 0x12, 0x80, 0x98,
+  0xBB, 0xCD, 0xCB, 0xCB, 0xCB, 0xBB, 0xCB, 0xBA, 0xBB, 0xBA, 0xAB, 0xAB,
+  0xAA, 0xA9, 0xA9, 0xAA, 0xCB, 0xCC, 0xDB, 0xDB, 0xCB, 0xBC, 0xBC, 0xBC,
+  0xBC, 0xCB, 0xBB, 0xAC, 0xBB, 0xCB, 0xAA, 0xAB, 0xAA, 0xA9, 0xA9, 0x99,
+  0xA9, 0xAA, 0xDB, 0xCC, 0xDB, 0xBC, 0xCC, 0xCB, 0xCB, 0xAC, 0xAC, 0xBB,
+  0xBB, 0xBB, 0xAB, 0x9A, 0x10, 0x53, 0x45, 0x35, 0x44, 0x34, 0x53, 0x33,
+  0x25, 0x24, 0x33, 0x43, 0x23, 0x24, 0x32, 0x22, 0x22, 0x12, 0x01, 0x80,
+  0x99, 0xCA, 0xCB, 0xBC, 0xBC, 0xCB, 0xBB, 0xAC, 0xBB, 0xAB, 0xBB, 0xBA,
+  0xAA, 0xAA, 0xA9, 0xA9, 0xBA, 0xBC, 0xBD, 0xBD, 0xBD, 0xCC, 0xCB, 0xCB,
+  0xCB, 0xCB, 0xBB, 0xBC, 0xCA, 0xBA, 0xBA, 0xBA, 0xBA, 0xAA, 0x9A, 0x9A,
+  0x9A, 0xA9, 0xBB, 0xCD, 0xDB, 0xBC, 0xBD, 0xBD, 0xDB, 0xBB, 0xCC, 0xBA,
+  0xCB, 0xBA, 0xAB, 0x9A, 0x89, 0x20, 0x63, 0x44, 0x44, 0x53, 0x43, 0x43,
+  0x43, 0x43, 0x33, 0x34, 0x33, 0x34, 0x32, 0x33, 0x33, 0x32, 0x21, 0x01,
+  0x88, 0xAA, 0xBC, 0xBD, 0xCC, 0xBB, 0xDB, 0xBA, 0xBB, 0xBB, 0xBB, 0xBB,
+  0xBB, 0xAA, 0xAA, 0xAA, 0xAA, 0xBB, 0xDC, 0xDB, 0xDB, 0xCB, 0xBC, 0xCC,
+  0xBB, 0xBC, 0xBC, 0xBC, 0xCA, 0xBA, 0xAB, 0xBB, 0xBB, 0xAB, 0xAB, 0x9A,
+  0xAA, 0xA9, 0xAA, 0xBC, 0xDC, 0xDB, 0xDB, 0xDB, 0xCB, 0xCB, 0xCB, 0xCB,
+  0xCA, 0xAA, 0xBB, 0xAA, 0x9A, 0x09, 0x31, 0x54, 0x35, 0x45, 0x43, 0x53,
+  0x33, 0x34, 0x34, 0x34, 0x33, 0x34, 0x42, 0x22, 0x23, 0x22, 0x22, 0x11,
+  0x00, 0x98, 0xB9, 0xDB, 0xCB, 0xBC, 0xCB, 0xCB, 0xBA, 0xBB, 0xCB, 0xAA,
+  0xAA, 0xAA, 0x9A, 0xA9, 0x99, 0x9A, 0xBB, 0xDB, 0xCC, 0xDB, 0xDB, 0xBB,
+  0xBD, 0xBC, 0xCB, 0xCB, 0xBB, 0xBC, 0xBA, 0xAC, 0xBA, 0xAA, 0xAA, 0x9A,
+  0x9A, 0x9A, 0x99, 0xBA, 0xCB, 0xCC, 0xCC, 0xBC, 0xCC, 0xBC, 0xCB, 0xBC,
+  0xCB, 0xBB, 0xAC, 0xAB, 0xAB, 0x99, 0x08, 0x42, 0x54, 0x44, 0x53, 0x43,
+  0x34, 0x43, 0x34, 0x43, 0x33, 0x34, 0x33, 0x43, 0x32, 0x23, 0x23, 0x12,
+  0x02, 0x00, 0x99, 0xCA, 0xCB, 0xBC, 0xCC, 0xBA, 0xAC, 0xBB, 0xBB, 0xBB,
+  0xCB, 0xAA, 0xA9, 0x9A, 0xA9, 0x99, 0xAA, 0xCA, 0xDB, 0xCB, 0xCC, 0xDB,
+  0xCB, 0xCB, 0xBB, 0xBD, 0xBB, 0xBC, 0xCB, 0xBA, 0xBB, 0xBB, 0xAB, 0xAB,
+  0xAB, 0x9A, 0x9A, 0xAA, 0xBB, 0xBD, 0xBE, 0xCC, 0xBC, 0xBD, 0xBC, 0xBC,
+  0xBC, 0xBC, 0xBB, 0xBC, 0xBA, 0x9A, 0x8A, 0x10, 0x53, 0x54, 0x53, 0x34,
+  0x44, 0x43, 0x43, 0x33, 0x34, 0x34, 0x33, 0x43, 0x33, 0x33, 0x23, 0x23,
+  0x22, 0x11, 0x88, 0xA9, 0xDB, 0xCB, 0xBC, 0xBC, 0xBC, 0xBB, 0xAC, 0xBB,
+  0xBB, 0xBA, 0xAB, 0xAB, 0xA9, 0x9A, 0xAA, 0xBA, 0xBC, 0xCD, 0xDB, 0xDB,
+  0xCB, 0xCB, 0xBC, 0xCB, 0xCB, 0xBB, 0xBC, 0xBB, 0xAC, 0xAB, 0xBB, 0xBA,
+  0xAA, 0x9A, 0x9A, 0x9A, 0xAA, 0xCA, 0xBC, 0xCD, 0xDB, 0xDB, 0xCB, 0xDB,
+  0xBB, 0xBC, 0xCB, 0xBB, 0xBB, 0xAC, 0xA9, 0x88, 0x20, 0x63, 0x44, 0x34,
+  0x35, 0x35, 0x43, 0x53, 0x32, 0x34, 0x42, 0x32, 0x33, 0x43, 0x32, 0x22,
+  0x22, 0x11, 0x01, 0x98, 0xA9, 0xDB, 0xCB, 0xCB, 0xCB, 0xCB, 0xBA, 0xBB,
+  0xBB, 0xAC, 0xAA, 0xAA, 0x9A, 0x9A, 0xA9, 0x99, 0xAB, 0xBC, 0xBD, 0xBD,
+  0xCC, 0xBC, 0xBC, 0xBC, 0xBC, 0xAC, 0xAC, 0xBB, 0xCB, 0xBA, 0xBA, 0xAB,
+  0xBA, 0xAA, 0x9A, 0x9A, 0x9A, 0xAA, 0xDB, 0xDB, 0xBC, 0xBD, 0xBD, 0xCC,
+  0xBB, 0xBD, 0xCB, 0xBB, 0xCB, 0xBA, 0xAA, 0x9A, 0x09, 0x31, 0x46, 0x63,
+  0x43, 0x34, 0x44, 0x43, 0x33, 0x34, 0x34, 0x33, 0x34, 0x33, 0x43, 0x32,
+  0x22, 0x12, 0x11, 0x81, 0x98, 0xAA, 0xCC, 0xCB, 0xCB, 0xCB, 0xBB, 0xCB,
+  0xAB, 0xBB, 0xBB, 0xBA, 0xAB, 0xAA, 0xA9, 0x9A, 0xBA, 0xBB, 0xBE, 0xCC,
+  0xBC, 0xBD, 0xCC, 0xBB, 0xCC, 0xBB, 0xBC, 0xCB, 0xBB, 0xCB, 0xBA, 0xAB,
+  0xAB, 0xAB, 0xAA, 0x9A, 0x9A, 0xA9, 0xBA, 0xCC, 0xDB, 0xCC, 0xDB, 0xCB,
+  0xBC, 0xBC, 0xBC, 0xCB, 0xCB, 0xBA, 0xBA, 0xAA, 0x8A, 0x18, 0x42, 0x45,
+  0x44, 0x34, 0x44, 0x43, 0x34, 0x33, 0x35, 0x33, 0x34, 0x33, 0x43, 0x23,
+  0x33, 0x22, 0x22, 0x11, 0x08, 0x99, 0xCB, 0xDB, 0xCB, 0xCB, 0xCB, 0xBA,
+  0xCB, 0xBA, 0xBA, 0xAB, 0xBA, 0xAA, 0xA9, 0x9A, 0xA9, 0xAA, 0xCB, 0xCC,
+  0xDB, 0xBC, 0xBC, 0xBD, 0xBC, 0xBC, 0xCB, 0xAC, 0xBB, 0xAC, 0xBB, 0xBB,
+  0xAB, 0xBB, 0xAB, 0xAA, 0xAA, 0x9A, 0xAA, 0xCB, 0xEB, 0xCB, 0xCC, 0xBC,
+  0xCC, 0xCB, 0xCB, 0xCB, 0xBB, 0xBC, 0xBB, 0xBA, 0x9B, 0x8A, 0x20, 0x63,
+  0x54, 0x53, 0x53, 0x43, 0x43, 0x43, 0x43, 0x33, 0x34, 0x33, 0x24, 0x33,
+  0x33, 0x33, 0x23, 0x22, 0x01, 0x90, 0xA9, 0xBC, 0xBD, 0xCC, 0xCA, 0xBA,
+  0xAC, 0xAB, 0xBB, 0xBB, 0xAB, 0xBB, 0xAA, 0x9A, 0xAA, 0x9A, 0xBB, 0xCC,
+  0xBC, 0xBD, 0xBD, 0xCC, 0xCB, 0xCB, 0xCB, 0xCB, 0xCA, 0xBA, 0xBA, 0xCB,
+  0xBA, 0xAA, 0xBA, 0x9A, 0xAA, 0x99, 0xA9, 0xA9, 0xCB, 0xDB, 0xBC, 0xCD,
+  0xCB, 0xBC, 0xCC, 0xBB, 0xBC, 0xBC, 0xCA, 0xAA, 0xAB, 0xA9, 0x88, 0x21,
+  0x44, 0x45, 0x53, 0x34, 0x34, 0x44, 0x33, 0x34, 0x43, 0x43, 0x32, 0x33,
+  0x24, 0x32, 0x22, 0x22, 0x02, 0x01, 0x98, 0xA9, 0xBC, 0xCC, 0xCB, 0xBB,
+  0xBC, 0xAC, 0xBB, 0xBB, 0xBA, 0xBB, 0xBA, 0xAA, 0x9A, 0xAA, 0xB9, 0xCA,
+  0xDB, 0xDB, 0xBC, 0xCC, 0xCB, 0xBC, 0xDB, 0xBB, 0xDB, 0xBA, 0xCB, 0xBA,
+  0xBB, 0xBB, 0xBB, 0xAB, 0xAB, 0xAA, 0x9A, 0xAA, 0xBA, 0xCC, 0xEB, 0xCB,
+  0xCC, 0xCB, 0xBC, 0xCC, 0xBB, 0xBC, 0xCB, 0xAB, 0xBB, 0xBB, 0x9A, 0x08,
+  0x42, 0x45, 0x44, 0x34, 0x35, 0x34, 0x44, 0x42, 0x32, 0x24, 0x43, 0x32,
+  0x23, 0x33, 0x33, 0x33, 0x22, 0x12, 0x00, 0x99, 0xCA, 0xBC, 0xCC, 0xCB,
+  0xBB, 0xBC, 0xBB, 0xCB, 0xAB, 0xAB, 0xAB, 0xAA, 0xAA, 0xA9, 0xA9, 0xAA,
+  0xCB, 0xDB, 0xBC, 0xBD, 0xCC, 0xDB, 0xBB, 0xBC, 0xBC, 0xAC, 0xAC, 0xBB,
+  0xBB, 0xBB, 0xAC, 0xBA, 0xAA, 0x9A, 0x9A, 0xA9, 0xA9, 0xAA, 0xCC, 0xDB,
+  0xBC, 0xBD, 0xBD, 0xBC, 0xBC, 0xBC, 0xBC, 0xCB, 0xBA, 0xAB, 0xAA, 0x8A,
+  0x18, 0x53, 0x44, 0x35, 0x35, 0x44, 0x33, 0x35, 0x43, 0x43, 0x33, 0x43,
+  0x33, 0x33, 0x24, 0x32, 0x22, 0x12, 0x01, 0x80, 0xA8, 0xCA, 0xDB, 0xBB,
+  0xBD, 0xBB, 0xBC, 0xCB, 0xBA, 0xAB, 0xAB, 0xAB, 0xAA, 0x9A, 0x9A, 0x9A,
+  0xAB, 0xDB, 0xDB, 0xBC, 0xCC, 0xDB, 0xBB, 0xBD, 0xCB, 0xCB, 0xCB, 0xBA,
+  0xCB, 0xBA, 0xBA, 0xAB, 0xAB, 0xAB, 0xAA, 0xA9, 0xA9, 0xAA, 0xBB, 0xBE,
+  0xCC, 0xCC, 0xDB, 0xCB, 0xCB, 0xBC, 0xCB, 0xBB, 0xBC, 0xBB, 0xAB, 0xAB,
+  0x89, 0x21, 0x44, 0x36, 0x35, 0x35, 0x44, 0x43, 0x33, 0x44, 0x42, 0x32,
+  0x33, 0x33, 0x34, 0x32, 0x23, 0x23, 0x21, 0x01, 0x88, 0xB9, 0xDB, 0xDB,
+  0xBB, 0xAD, 0xAC, 0xAB, 0xCB, 0xAA, 0xAB, 0xAA, 0xAA, 0xAA, 0xA9, 0xA9,
+  0xA9, 0xBA, 0xDB, 0xDB, 0xBC, 0xCC, 0xBC, 0xBC, 0xBC, 0xBC, 0xDB, 0xBA,
+  0xCB, 0xBA, 0xBB, 0xBB, 0xBB, 0xBA, 0xAB, 0xAA, 0xAA, 0x9A, 0xBB, 0xDB,
+  0xCC, 0xDB, 0xBC, 0xBD, 0xBC, 0xBD, 0xCB, 0xCB, 0xBB, 0xAC, 0xBB, 0xBA,
+  0xA9, 0x88, 0x31, 0x55, 0x53, 0x44, 0x43, 0x34, 0x34, 0x34, 0x34, 0x33,
+  0x34, 0x24, 0x33, 0x33, 0x33, 0x33, 0x32, 0x21, 0x00, 0x98, 0xCA, 0xCB,
+  0xCC, 0xBB, 0xBC, 0xBC, 0xBB, 0xAC, 0xBB, 0xBA, 0xBA, 0xAA, 0xAA, 0xA9,
+  0xA9, 0xAA, 0xBB, 0xCD, 0xDB, 0xDB, 0xCB, 0xDB, 0xBB, 0xBD, 0xCB, 0xBB,
+  0xBC, 0xCB, 0xBA, 0xBB, 0xBB, 0xBB, 0xBB, 0xBA, 0x9A, 0xAA, 0xAA, 0xBB,
+  0xCC, 0xCC, 0xBC, 0xCD, 0xCB, 0xBC, 0xDB, 0xBB, 0xBC, 0xBC, 0xAB, 0xAC,
+  0x9A, 0x99, 0x08, 0x32, 0x45, 0x35, 0x35, 0x35, 0x53, 0x33, 0x44, 0x42,
+  0x32, 0x33, 0x24, 0x33, 0x33, 0x33, 0x33, 0x22, 0x12, 0x80, 0xA8, 0xCB,
+  0xBC, 0xBD, 0xBC, 0xCB, 0xBB, 0xBC, 0xBA, 0xBB, 0xBB, 0xBB, 0xBA, 0xAA,
+  0xA9, 0xAA, 0xAB, 0xBC, 0xCC, 0xCC, 0xDB, 0xCB, 0xBC, 0xBC, 0xDB, 0xBB,
+  0xAC, 0xAC, 0xBB, 0xBB, 0xAC, 0xAB, 0xBA, 0xAA, 0x9A, 0xAA, 0x99, 0xAA,
+  0xBA, 0xCC, 0xCC, 0xDB, 0xBC, 0xCC, 0xCB, 0xCB, 0xCB, 0xBB, 0xBC, 0xBB,
+  0xAB, 0xAB, 0x8A, 0x28, 0x63, 0x44, 0x35, 0x44, 0x53, 0x33, 0x34, 0x44,
+  0x32, 0x24, 0x33, 0x43, 0x23, 0x33, 0x32, 0x23, 0x12, 0x11, 0x88, 0xA9,
+  0xCB, 0xCC, 0xCB, 0xCB, 0xBB, 0xCB, 0xBB, 0xAC, 0xBA, 0xAA, 0xAB, 0x9A,
+  0x9A, 0x9A, 0x9A, 0xAB, 0xDB, 0xDB, 0xCB, 0xCC, 0xCB, 0xBC, 0xDB, 0xBB,
+  0xBC, 0xAC, 0xAC, 0xBA, 0xBB, 0xBB, 0xCB, 0xAA, 0xA9, 0x9A, 0x9A, 0xA9,
+  0xA9, 0xBA, 0xBD, 0xCD, 0xDB, 0xCB, 0xBC, 0xCC, 0xBB, 0xBC, 0xBC, 0xBB,
+  0xCB, 0xAA, 0xAA, 0x88, 0x20, 0x44, 0x45, 0x53, 0x53, 0x43, 0x43, 0x43,
+  0x33, 0x34, 0x34, 0x42, 0x32, 0x32, 0x33, 0x32, 0x22, 0x12, 0x01, 0x90,
+  0xAA, 0xBC, 0xBD, 0xCC, 0xCA, 0xBA, 0xBB, 0xAC, 0xBB, 0xBA, 0xAB, 0xAB,
+  0xAA, 0x9A, 0xAA, 0xA9, 0xBB, 0xBD, 0xCC, 0xCC, 0xCB, 0xBC, 0xBC, 0xAD,
+  0xAC, 0xCB, 0xBA, 0xAC, 0xBB, 0xBB, 0xBB, 0xBB, 0xBB, 0xBA, 0xBA, 0x9A,
+  0xAA, 0xBA, 0xCC, 0xBC, 0xCD, 0xDB, 0xDB, 0xCB, 0xCB, 0xCB, 0xBB, 0xBC,
+  0xBB, 0xAC, 0xAB, 0xA9, 0x08, 0x31, 0x55, 0x53, 0x34, 0x35, 0x34, 0x34,
+  0x44, 0x32, 0x24, 0x43, 0x32, 0x33, 0x33, 0x33, 0x23, 0x23, 0x12, 0x00,
+  0xA8, 0xBA, 0xBE, 0xBC, 0xBC, 0xBC, 0xCB, 0xBB, 0xBB, 0xAC, 0xAB, 0xAA,
+  0x9B, 0xAA, 0x9A, 0x9A, 0x9A, 0xCB, 0xDB, 0xDB, 0xCB, 0xBC, 0xBD, 0xDB,
+  0xBB, 0xBC, 0xAC, 0xAC, 0xBB, 0xBB, 0xAC, 0xAB, 0xAB, 0xAA, 0xAA, 0xAA,
+  0x99, 0xAA, 0xBA, 0xDB, 0xCC, 0xEB, 0xCB, 0xDB, 0xCB, 0xBB, 0xBD, 0xCB,
+  0xBB, 0xCB, 0xBA, 0xAA, 0x99, 0x00, 0x43, 0x54, 0x44, 0x53, 0x43, 0x43,
+  0x34, 0x43, 0x43, 0x33, 0x43, 0x33, 0x43, 0x32, 0x32, 0x22, 0x12, 0x11,
+  0x80, 0x99, 0xCA, 0xDB, 0xBB, 0xBD, 0xBB, 0xBC, 0xAC, 0xBB, 0xBA, 0xBB,
+  0xBA, 0xAA, 0xAA, 0x9A, 0xAA, 0xBA, 0xDB, 0xDB, 0xDB, 0xDB, 0xCB, 0xCB,
+  0xBC, 0xCB, 0xBC, 0xCA, 0xBB, 0xBB, 0xAC, 0xBB, 0xBB, 0xAB, 0xBB, 0xAA,
+  0x9A, 0xAA, 0xB9, 0xBB, 0xCD, 0xBC, 0xCD, 0xDB, 0xCB, 0xBC, 0xCB, 0xBC,
+  0xBB, 0xBC, 0xBB, 0xBB, 0xAB, 0x99, 0x20, 0x54, 0x44, 0x44, 0x34, 0x34,
+  0x35, 0x43, 0x43, 0x43, 0x32, 0x24, 0x33, 0x33, 0x33, 0x33, 0x23, 0x13,
+  0x11, 0x90, 0xB9, 0xCC, 0xCB, 0xBC, 0xBC, 0xBC, 0xCA, 0xBA, 0xBA, 0xBB,
+  0xAB, 0xAB, 0xAB, 0x9A, 0xAA, 0xB9, 0xBA, 0xBC, 0xCD, 0xDB, 0xBC, 0xBC,
+  0xBD, 0xCB, 0xBC, 0xBB, 0xAD, 0xBB, 0xAC, 0xBB, 0xAB, 0xBB, 0xBB, 0xBA,
+  0x9A, 0x9B, 0xAA, 0xAA, 0xDB, 0xDB, 0xDB, 0xDB, 0xCB, 0xBC, 0xBC, 0xBC,
+  0xBC, 0xCB, 0xBB, 0xBB, 0xBB, 0x9B, 0x0A, 0x31, 0x55, 0x44, 0x34, 0x35,
+  0x35, 0x43, 0x43, 0x43, 0x33, 0x34, 0x33, 0x43, 0x23, 0x33, 0x23, 0x23,
+  0x12, 0x00, 0x90, 0xBA, 0xCC, 0xBC, 0xBC, 0xDB, 0xBA, 0xAC, 0xBA, 0xBB,
+  0xAB, 0xBB, 0xAB, 0xAA, 0x9A, 0xAA, 0xAA, 0xCA, 0xDB, 0xDB, 0xCB, 0xCC,
+  0xCB, 0xCB, 0xBC, 0xCB, 0xBB, 0xBC, 0xAC, 0xBB, 0xCB, 0xAA, 0xBA, 0xAA,
+  0xAA, 0xA9, 0x99, 0x9A, 0xAA, 0xDB, 0xDB, 0xCB, 0xBC, 0xBD, 0xBD, 0xCB,
+  0xCB, 0xAC, 0xBB, 0xAC, 0xAB, 0xAB, 0x99, 0x19, 0x31, 0x46, 0x44, 0x53,
+  0x53, 0x33, 0x44, 0x33, 0x34, 0x43, 0x43, 0x32, 0x33, 0x33, 0x33, 0x33,
+  0x23, 0x12, 0x00, 0xA9, 0xCB, 0xEB, 0xBB, 0xCC, 0xBB, 0xCB, 0xBB, 0xCB,
+  0xAB, 0xBA, 0xAB, 0xAA, 0x9A, 0xAA, 0x9A, 0xAA, 0xDB, 0xBB, 0xBD, 0xDC,
+  0xBB, 0xBD, 0xBC, 0xBC, 0xBC, 0xCB, 0xBB, 0xBC, 0xAB, 0xAC, 0xBA, 0xAA,
+  0xAB, 0xA9, 0x9A, 0xA9, 0xA9, 0xBA, 0xBC, 0xBC, 0xBE, 0xEB, 0xCB, 0xCB,
+  0xAC, 0xBC, 0xBB, 0xBC, 0xBB, 0xBB, 0x9C, 0x8A, 0x00, 0x42, 0x45, 0x63,
+  0x43, 0x43, 0x34, 0x34, 0x43, 0x24, 0x33, 0x34, 0x33, 0x43, 0x32, 0x32,
+  0x22, 0x22, 0x01, 0x80, 0x99, 0xCB, 0xBC, 0xCC, 0xBB, 0xBC, 0xCB, 0xAB,
+  0xCB, 0xAA, 0xAB, 0xAA, 0x9A, 0x9A, 0x9A, 0x9A, 0xAA, 0xDB, 0xBB, 0xBC,
+  0xBE, 0xDB, 0xDB, 0xCA, 0xBA, 0xBC, 0xCB, 0xBB, 0xBB, 0xBC, 0xBB, 0xBB,
+  0xBB, 0xAB, 0xAB, 0x9A, 0xAB, 0xBA, 0xBB, 0xDB, 0xCB, 0xDB, 0xCB, 0xBC,
+  0xCC, 0xBB, 0xCC, 0xBA, 0xCB, 0xAB, 0xAB, 0xAA, 0x89, 0x21, 0x63, 0x44,
+  0x44, 0x43, 0x34, 0x35, 0x33, 0x35, 0x33, 0x34, 0x24, 0x33, 0x33, 0x24,
+  0x22, 0x22, 0x12, 0x00, 0x90, 0xA9, 0xCB, 0xEB, 0xBA, 0xBC, 0xCB, 0xBB,
+  0xBB, 0xBC, 0xBA, 0xAB, 0xAA, 0xAA, 0xAA, 0x99, 0xAB, 0xBB, 0xCB, 0xCB,
+  0xDB, 0xCB, 0xBC, 0xBD, 0xCB, 0xCB, 0xCB, 0xBA, 0xAC, 0xBB, 0xAC, 0xAB,
+  0xAB, 0xAA, 0xAA, 0x9A, 0x9A, 0xAA, 0xAA, 0xBB, 0xDB, 0xBB, 0xBD, 0xCC,
+  0xBC, 0xDB, 0xBB, 0xAD, 0xBB, 0xAC, 0xBB, 0xBA, 0x9A, 0x88, 0x31, 0x45,
+  0x35, 0x45, 0x43, 0x43, 0x34, 0x43, 0x24, 0x43, 0x33, 0x33, 0x24, 0x33,
+  0x33, 0x23, 0x23, 0x12, 0x01, 0x99, 0xC9, 0xCB, 0xBC, 0xAD, 0xCB, 0xBB,
+  0xCB, 0xBB, 0xBA, 0xAC, 0xAA, 0xA9, 0xA9, 0x99, 0x9A, 0xAA, 0xBB, 0xBB,
+  0xBD, 0xCB, 0xBC, 0xBD, 0xDB, 0xBB, 0xAD, 0xCB, 0xBA, 0xAC, 0xBB, 0xBB,
+  0xBB, 0xBB, 0xAB, 0xAB, 0xAB, 0xAA, 0x9A, 0xAB, 0xBA, 0xDB, 0xBB, 0xCC,
+  0xDB, 0xCB, 0xCB, 0xCB, 0xBB, 0xAD, 0xAB, 0xBB, 0xAA, 0xA9, 0x00, 0x32,
+  0x37, 0x35, 0x36, 0x53, 0x43, 0x43, 0x33, 0x34, 0x34, 0x43, 0x32, 0x33,
+  0x24, 0x32, 0x22, 0x21, 0x11, 0x00, 0x99, 0xBA, 0xBD, 0xBC, 0xBC, 0xBC,
+  0xAC, 0xBB, 0xAC, 0xBA, 0xAA, 0xAB, 0xAA, 0xA9, 0x9A, 0xAA, 0xAA, 0xBA,
+  0xBB, 0xBD, 0xBB, 0xBD, 0xBD, 0xDB, 0xBB, 0xBC, 0xBC, 0xBB, 0xBC, 0xBB,
+  0xCB, 0xBA, 0xAA, 0xAB, 0x9A, 0xAA, 0x9A, 0x9A, 0xAB, 0xBA, 0xCB, 0xCB,
+  0xDB, 0xCB, 0xDB, 0xBB, 0xBC, 0xBC, 0xCB, 0xAB, 0xAB, 0xAB, 0x99, 0x10,
+  0x53, 0x45, 0x53, 0x34, 0x44, 0x33, 0x35, 0x43, 0x33, 0x34, 0x24, 0x33,
+  0x33, 0x24, 0x23, 0x22, 0x21, 0x01, 0x90, 0xA8
+};
+
+const adpcm_clip_t PLUCK = {
+  PLUCK_DATA, 4096, 32000, 0, 59
+};
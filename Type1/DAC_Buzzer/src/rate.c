@@ -0,0 +1,32 @@
+#include "rate.h"
+
+// Standard audio sample rates, from lowest to highest.
+const uint32_t RATE_STD[ RATE_NUM_STD ] = {
+  RATE_8K, RATE_16K, RATE_22K05, RATE_44K1, RATE_48K
+};
+
+// Find timer prescaler / auto-reload values which divide a
+// 'clk' Hertz timer clock down as close to 'want' Hertz as
+// possible, and the error in the resulting rate.
+// The prescaler is kept as small as possible, because every
+// step it adds makes the auto-reload value coarser.
+// Returns 0 on success, or -1 if the rate is out of range.
+int rate_calc( uint32_t clk, uint32_t want, rate_cfg_t *cfg ) {
+  if ( want == 0 || want > ( clk / 2 ) ) { return -1; }
+  // Total division, rounded to the nearest count.
+  uint32_t div = ( clk + ( want / 2 ) ) / want;
+  uint32_t psc = ( div - 1 ) / 65536;
+  if ( psc > 0xFFFF ) { return -1; }
+  uint32_t step = ( psc + 1 ) * want;
+  uint32_t arr  = ( clk + ( step / 2 ) ) / step;
+  if ( arr > 65536 ) { arr = 65536; }
+  div = ( psc + 1 ) * arr;
+  cfg->want = want;
+  cfg->psc  = ( uint16_t )psc;
+  cfg->arr  = ( uint16_t )( arr - 1 );
+  cfg->rate = ( clk + ( div / 2 ) ) / div;
+  // ( clk / div - want ) / want, scaled by 10^6.
+  int64_t err = ( int64_t )clk * 1000000 - ( int64_t )want * div * 1000000;
+  cfg->err_ppm = ( int32_t )( err / ( ( int64_t )want * div ) );
+  return 0;
+}
@@ -0,0 +1,35 @@
+#include "seq.h"
+
+// Envelopes: a plucked lead, and a softer bass.
+static const seq_env_t SONG_ENVS[ 2 ] = {
+  { 5, 150, 80, 128, 192 },
+  { 10, 300, 150, 160, 240 }
+};
+
+// Melody, in quarter notes. (2 ticks per beat)
+static const seq_event_t SONG_LEAD[ ] = {
+  { 72, 0, 2 }, { 72, 0, 2 }, { 79, 0, 2 }, { 79, 0, 2 },
+  { 81, 0, 2 }, { 81, 0, 2 }, { 79, 0, 4 },
+  { 77, 0, 2 }, { 77, 0, 2 }, { 76, 0, 2 }, { 76, 0, 2 },
+  { 74, 0, 2 }, { 74, 0, 2 }, { 72, 0, 4 },
+  { SEQ_END, 0, 0 }
+};
+
+// Bass line, in half and whole notes.
+static const seq_event_t SONG_BASS[ ] = {
+  { 48, 1, 8 },
+  { 53, 1, 4 }, { 48, 1, 4 },
+  { 53, 1, 4 }, { 48, 1, 4 },
+  { 43, 1, 4 }, { 48, 1, 4 },
+  { SEQ_END, 0, 0 }
+};
+
+static const seq_track_t SONG_TRACKS[ 2 ] = {
+  { SONG_LEAD, WAVE_TRIANGLE_BL, 160 },
+  { SONG_BASS, WAVE_SAW_BL, 96 }
+};
+
+// Four bars at 120 beats per minute, repeated.
+const seq_song_t SONG = {
+  SONG_TRACKS, 2, SONG_ENVS, 120, 2, 1
+};
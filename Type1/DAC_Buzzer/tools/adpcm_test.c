@@ -0,0 +1,65 @@
+// Decode IMA-ADPCM clips with 'src/adpcm.c' on the host machine,
+// for 'tools/adpcm_check.py' to compare against a reference decoder.
+// Build and run both with 'make adpcm-test'.
+//
+// Two clips are decoded: the bundled 'PLUCK' clip, and a block of
+// pseudo-random codes which drives the predictor and step index
+// into their limits. For each clip, the output file holds:
+// - The sample count (uint32), starting 'pred' (int16) and 'index'
+//   (uint8), and one byte of padding.
+// - The clip's code bytes, two codes per byte, low nibble first.
+// - The decoded 12-bit DAC values (uint16).
+// All values are little-endian.
+#include <stdint.h>
+#include <stdio.h>
+
+#include "adpcm.h"
+
+extern const adpcm_clip_t PLUCK;
+
+#define NOISE_LEN ( 8192 )
+static uint8_t NOISE_DATA[ NOISE_LEN / 2 ];
+
+static void write_clip( FILE *f, const adpcm_clip_t *clip ) {
+  uint8_t pad = 0;
+  fwrite( &clip->len, 4, 1, f );
+  fwrite( &clip->pred, 2, 1, f );
+  fwrite( &clip->index, 1, 1, f );
+  fwrite( &pad, 1, 1, f );
+  fwrite( clip->data, 1, ( clip->len + 1 ) / 2, f );
+  adpcm_t dec;
+  adpcm_start( &dec, clip, 0 );
+  uint16_t buf[ 256 ];
+  uint32_t left = clip->len;
+  while ( left ) {
+    size_t n = adpcm_fill( &dec, buf, 256 );
+    if ( n > left ) { n = left; }
+    fwrite( buf, 2, n, f );
+    left -= n;
+  }
+}
+
+// Usage: adpcm_test <output file>
+int main( int argc, char **argv ) {
+  if ( argc != 2 ) {
+    fprintf( stderr, "Usage: %s <output file>\n", argv[ 0 ] );
+    return 1;
+  }
+  // (A fixed linear congruential generator, so the codes are the
+  // same on every run)
+  uint32_t seed = 1;
+  for ( size_t i = 0; i < sizeof( NOISE_DATA ); ++i ) {
+    seed = ( seed * 1664525 ) + 1013904223;
+    NOISE_DATA[ i ] = ( uint8_t )( seed >> 24 );
+  }
+  const adpcm_clip_t noise = { NOISE_DATA, NOISE_LEN, 32000, -32768, 88 };
+  FILE *f = fopen( argv[ 1 ], "wb" );
+  if ( !f ) {
+    perror( argv[ 1 ] );
+    return 1;
+  }
+  write_clip( f, &PLUCK );
+  write_clip( f, &noise );
+  fclose( f );
+  return 0;
+}
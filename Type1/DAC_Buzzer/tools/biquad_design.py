@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# Design biquad filter sections for 'biquad_t' (see src/biquad.h),
+# and print them as C initializers.
+#
+# Usage: biquad_design.py <type> <sample rate> <frequency>
+#                         [--q Q] [--gain dB] [--order N]
+#
+# Types: lowpass, highpass, bandpass, notch, peak (from the 'Audio
+# EQ Cookbook' formulas). With '--order', lowpass and highpass
+# filters are designed as Butterworth cascades of ( N / 2 ) sections.
+#
+# Coefficients are printed in Q2.14 fixed-point, with the feedback
+# terms negated: y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2]
+#                                + a1*y[n-1] + a2*y[n-2]
+# The quantized poles are checked, because sections with very low
+# cutoffs can become unstable at 14 fractional bits.
+import argparse
+import cmath
+import math
+import sys
+
+FRAC = 14
+
+def rbj( kind, fs, f0, q, gain ):
+  w0 = 2 * math.pi * f0 / fs
+  cw, sw = math.cos( w0 ), math.sin( w0 )
+  alpha = sw / ( 2 * q )
+  A = 10 ** ( gain / 40 )
+  if kind == 'lowpass':
+    b = [ ( 1 - cw ) / 2, 1 - cw, ( 1 - cw ) / 2 ]
+    a = [ 1 + alpha, -2 * cw, 1 - alpha ]
+  elif kind == 'highpass':
+    b = [ ( 1 + cw ) / 2, -( 1 + cw ), ( 1 + cw ) / 2 ]
+    a = [ 1 + alpha, -2 * cw, 1 - alpha ]
+  elif kind == 'bandpass':
+    b = [ alpha, 0, -alpha ]
+    a = [ 1 + alpha, -2 * cw, 1 - alpha ]
+  elif kind == 'notch':
+    b = [ 1, -2 * cw, 1 ]
+    a = [ 1 + alpha, -2 * cw, 1 - alpha ]
+  elif kind == 'peak':
+    b = [ 1 + alpha * A, -2 * cw, 1 - alpha * A ]
+    a = [ 1 + alpha / A, -2 * cw, 1 - alpha / A ]
+  else:
+    sys.exit( 'Unknown filter type: %s' % kind )
+  return [ b[ 0 ] / a[ 0 ], b[ 1 ] / a[ 0 ], b[ 2 ] / a[ 0 ],
+           -a[ 1 ] / a[ 0 ], -a[ 2 ] / a[ 0 ] ]
+
+# Q factors of the sections of an even-order Butterworth filter.
+def butterworth_qs( order ):
+  return [ 1 / ( 2 * math.cos( math.pi * ( 2 * k + 1 ) / ( 2 * order ) ) )
+           for k in range( order // 2 ) ]
+
+def quantize( c ):
+  q = [ int( round( v * ( 1 << FRAC ) ) ) for v in c ]
+  for v in q:
+    if not -32768 <= v <= 32767:
+      sys.exit( 'Coefficient %.5f does not fit in Q2.14.' % ( v / ( 1 << FRAC ) ) )
+  return q
+
+# Largest pole radius of a quantized section; must be below 1.
+def pole_radius( q ):
+  a1, a2 = q[ 3 ] / ( 1 << FRAC ), q[ 4 ] / ( 1 << FRAC )
+  # Poles are the roots of z^2 - a1*z - a2.
+  d = cmath.sqrt( a1 * a1 + 4 * a2 )
+  return max( abs( ( a1 + d ) / 2 ), abs( ( a1 - d ) / 2 ) )
+
+def main():
+  ap = argparse.ArgumentParser( description='Design Q2.14 biquad sections.' )
+  ap.add_argument( 'type' )
+  ap.add_argument( 'rate', type=float )
+  ap.add_argument( 'freq', type=float )
+  ap.add_argument( '--q', type=float, default=math.sqrt( 0.5 ) )
+  ap.add_argument( '--gain', type=float, default=0.0 )
+  ap.add_argument( '--order', type=int, default=0 )
+  args = ap.parse_args()
+  if not 0 < args.freq < args.rate / 2:
+    sys.exit( 'The frequency must be between 0 and half the sample rate.' )
+  if args.order:
+    if args.type not in ( 'lowpass', 'highpass' ) or args.order % 2 or \
+       not 2 <= args.order <= 8:
+      sys.exit( 'Butterworth filters must be lowpass / highpass, order 2-8.' )
+    qs = butterworth_qs( args.order )
+    desc = 'Butterworth %s, order %d' % ( args.type, args.order )
+  else:
+    qs = [ args.q ]
+    desc = '%s, Q = %.3f' % ( args.type, args.q )
+    if args.type == 'peak': desc += ', %+.1fdB' % args.gain
+  print( '// %s at %gHz, for %gHz samples.' % ( desc, args.freq, args.rate ) )
+  for q in qs:
+    c = quantize( rbj( args.type, args.rate, args.freq, q, args.gain ) )
+    r = pole_radius( c )
+    print( '{ %6d, %6d, %6d, %6d, %6d },' % tuple( c ) )
+    if r >= 1.0:
+      sys.exit( 'Unstable after quantization (pole radius %.5f).' % r )
+    if r > 0.999:
+      sys.stderr.write( 'Warning: pole radius %.5f; expect noise and '
+                        'limit cycles.\n' % r )
+
+if __name__ == '__main__':
+  main()
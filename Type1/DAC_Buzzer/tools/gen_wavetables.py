@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+# Generate the DDS wavetables as a C source / header pair.
+#
+# Usage: gen_wavetables.py <table bits> <harmonics> <output base>
+#
+# Writes '<output base>.c' and '<output base>.h', with one table of
+# ( 1 << table bits ) signed 12-bit samples for each waveform. The
+# '_BL' tables are band-limited: they are built from the waveform's
+# first <harmonics> harmonics, so they alias much less when they are
+# played at high pitches. The Makefile runs this at build time.
+import math
+import sys
+
+PEAK = 2047
+
+def naive( shape, n ):
+  out = []
+  for i in range( n ):
+    x = i / n
+    if shape == 'SINE':
+      v = math.sin( 2 * math.pi * x )
+    elif shape == 'SAW':
+      v = 2 * ( ( x + 0.5 ) % 1.0 ) - 1
+    elif shape == 'SQUARE':
+      v = 1.0 if x < 0.5 else -1.0
+    elif shape == 'TRIANGLE':
+      v = 1 - abs( 4 * ( ( x + 0.25 ) % 1.0 ) - 2 )
+    out.append( v )
+  return out
+
+# Fourier series, with the same phase as the naive waveforms.
+def band_limited( shape, n, harmonics ):
+  # Harmonics above n / 2 cannot be represented in the table.
+  harmonics = max( 1, min( harmonics, n // 2 - 1 ) )
+  out = []
+  for i in range( n ):
+    x = 2 * math.pi * i / n
+    v = 0.0
+    for k in range( 1, harmonics + 1 ):
+      if shape == 'SAW':
+        v += ( -1 if k % 2 == 0 else 1 ) * math.sin( k * x ) / k
+      elif shape == 'SQUARE' and k % 2:
+        v += math.sin( k * x ) / k
+      elif shape == 'TRIANGLE' and k % 2:
+        v += ( -1 if ( k // 2 ) % 2 else 1 ) * math.sin( k * x ) / ( k * k )
+    out.append( v )
+  peak = max( abs( v ) for v in out )
+  return [ v / peak for v in out ]
+
+def main():
+  if len( sys.argv ) != 4:
+    sys.exit( 'Usage: %s <table bits> <harmonics> <output base>' % sys.argv[ 0 ] )
+  bits, harmonics, base = int( sys.argv[ 1 ] ), int( sys.argv[ 2 ] ), sys.argv[ 3 ]
+  if not 2 <= bits <= 12:
+    sys.exit( 'Table bits must be between 2 and 12.' )
+  n = 1 << bits
+  tables = [ ( 'SINE', naive( 'SINE', n ) ),
+             ( 'SAW', naive( 'SAW', n ) ),
+             ( 'SQUARE', naive( 'SQUARE', n ) ),
+             ( 'TRIANGLE', naive( 'TRIANGLE', n ) ),
+             ( 'SAW_BL', band_limited( 'SAW', n, harmonics ) ),
+             ( 'SQUARE_BL', band_limited( 'SQUARE', n, harmonics ) ),
+             ( 'TRIANGLE_BL', band_limited( 'TRIANGLE', n, harmonics ) ) ]
+  name = base.split( '/' )[ -1 ]
+  guard = '__VVC_%s_H' % name.upper()
+
+  h = [ '// Generated by tools/gen_wavetables.py; do not edit.',
+        '#ifndef %s' % guard,
+        '#define %s' % guard,
+        '',
+        '// Standard library includes.',
+        '#include <stdint.h>',
+        '',
+        '// Number of wavetable entries, as a power of two.',
+        '#define WAVE_TABLE_BITS ( %d )' % bits,
+        '#define WAVE_TABLE_LEN  ( 1 << WAVE_TABLE_BITS )',
+        '// Highest harmonic in the band-limited tables.',
+        '#define WAVE_HARMONICS  ( %d )' % max( 1, min( harmonics, n // 2 - 1 ) ),
+        '',
+        '// One cycle of each waveform, as signed 12-bit samples.' ]
+  for t, _ in tables:
+    h.append( 'extern const int16_t WAVE_%s[ WAVE_TABLE_LEN ];' % t )
+  h += [ '', '#endif', '' ]
+
+  c = [ '// Generated by tools/gen_wavetables.py; do not edit.',
+        '#include "%s.h"' % name,
+        '' ]
+  for t, vals in tables:
+    c.append( '// %s.' % t.replace( '_BL', ', band-limited' ).lower().capitalize() )
+    c.append( 'const int16_t WAVE_%s[ WAVE_TABLE_LEN ] __attribute__( ( aligned( 16 ) ) ) = {' % t )
+    q = [ max( -PEAK, min( PEAK, int( round( v * PEAK ) ) ) ) for v in vals ]
+    for i in range( 0, n, 8 ):
+      row = ', '.join( '%5d' % v for v in q[ i:i + 8 ] )
+      c.append( '  ' + row + ( ',' if i + 8 < n else '' ) )
+    c += [ '};', '' ]
+
+  with open( base + '.h', 'w' ) as f:
+    f.write( '\n'.join( h ) )
+  with open( base + '.c', 'w' ) as f:
+    f.write( '\n'.join( c ) )
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,402 @@
+// Run the firmware on the host machine, with simulated peripherals.
+// Build and run it with 'make host'.
+//
+// The device headers point each peripheral at its real address, so
+// this maps plain memory over the peripheral and core register
+// ranges, and runs the firmware's 'main' function (renamed to
+// 'firmware_main') in its own thread. The main thread plays the
+// part of the hardware: it carries out memory-to-memory DMA
+// transfers, and clocks the DAC's DMA channel at the TIM6 rate,
+// calling the firmware's DMA interrupt handler when the channel's
+// 'half transfer' and 'transfer complete' flags are set. Every
+// sample which reaches the DAC is saved to a WAV file.
+//
+// Samples are simulated as fast as the host can produce them, not
+// in real time, so the cycle counts which the firmware records are
+// host times scaled to the core clock; they are only useful for
+// comparing one kernel against another. (The firmware's 'bench'
+// module reads them from 'clock_gettime' in host builds)
+//
+// The program must be linked at a fixed address below 4GB ('-no-pie'),
+// because the firmware stores pointers in 32-bit DMA registers.
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+// Vendor-provided device header file.
+#if defined( VVC_F3 )
+  #include "stm32f3xx.h"
+#elif defined( VVC_F4 )
+  #include "stm32f4xx.h"
+#elif defined( VVC_G0 )
+  #include "stm32g0xx.h"
+#endif
+// Project includes.
+#include "bench.h"
+#include "clock.h"
+
+// Firmware symbols.
+int firmware_main( void );
+extern uint32_t SystemCoreClock;
+extern volatile uint32_t audio_underruns;
+extern volatile uint32_t audio_worst_cycles;
+
+// Address ranges to back with memory: the peripheral buses, and the
+// core's debug and system control registers.
+#define SIM_PERIPH_START ( 0x40000000UL )
+#define SIM_PERIPH_SIZE  ( 0x10100000UL )
+#define SIM_CORE_START   ( 0xE0000000UL )
+#define SIM_CORE_SIZE    ( 0x00100000UL )
+
+typedef void ( *sim_handler_t )( void );
+
+#if defined( VVC_F4 )
+// Interrupt handler names, from the vector table.
+#define SIM_WEAK( name ) void name( void ) __attribute__( ( weak ) )
+SIM_WEAK( DMA_Stream0_IRQ_handler );
+SIM_WEAK( DMA_Stream1_IRQ_handler );
+SIM_WEAK( DMA_Stream2_IRQ_handler );
+SIM_WEAK( DMA_Stream3_IRQ_handler );
+SIM_WEAK( DMA_Stream4_IRQ_handler );
+SIM_WEAK( DMA_Stream5_IRQ_handler );
+SIM_WEAK( DMA_Stream6_IRQ_handler );
+SIM_WEAK( DMA1_Stream7_IRQ_handler );
+SIM_WEAK( DMA2_Stream0_IRQ_handler );
+SIM_WEAK( DMA2_Stream1_IRQ_handler );
+SIM_WEAK( DMA2_Stream2_IRQ_handler );
+SIM_WEAK( DMA2_Stream3_IRQ_handler );
+SIM_WEAK( DMA2_Stream4_IRQ_handler );
+SIM_WEAK( DMA2_Stream5_IRQ_handler );
+SIM_WEAK( DMA2_Stream6_IRQ_handler );
+SIM_WEAK( DMA2_Stream7_IRQ_handler );
+#define SIM_CHANNELS ( 16 )
+static DMA_Stream_TypeDef *const SIM_CH[ SIM_CHANNELS ] = {
+  DMA1_Stream0, DMA1_Stream1, DMA1_Stream2, DMA1_Stream3,
+  DMA1_Stream4, DMA1_Stream5, DMA1_Stream6, DMA1_Stream7,
+  DMA2_Stream0, DMA2_Stream1, DMA2_Stream2, DMA2_Stream3,
+  DMA2_Stream4, DMA2_Stream5, DMA2_Stream6, DMA2_Stream7
+};
+static sim_handler_t SIM_IRQ[ SIM_CHANNELS ] = {
+  DMA_Stream0_IRQ_handler, DMA_Stream1_IRQ_handler,
+  DMA_Stream2_IRQ_handler, DMA_Stream3_IRQ_handler,
+  DMA_Stream4_IRQ_handler, DMA_Stream5_IRQ_handler,
+  DMA_Stream6_IRQ_handler, DMA1_Stream7_IRQ_handler,
+  DMA2_Stream0_IRQ_handler, DMA2_Stream1_IRQ_handler,
+  DMA2_Stream2_IRQ_handler, DMA2_Stream3_IRQ_handler,
+  DMA2_Stream4_IRQ_handler, DMA2_Stream5_IRQ_handler,
+  DMA2_Stream6_IRQ_handler, DMA2_Stream7_IRQ_handler
+};
+#define SIM_CR( c )   ( SIM_CH[ c ]->CR )
+#define SIM_NDTR( c ) ( SIM_CH[ c ]->NDTR )
+#define SIM_PAR( c )  ( SIM_CH[ c ]->PAR )
+#define SIM_EN        ( DMA_SxCR_EN )
+#define SIM_CIRC      ( DMA_SxCR_CIRC )
+#define SIM_MINC      ( DMA_SxCR_MINC )
+#define SIM_PINC      ( DMA_SxCR_PINC )
+#define SIM_HTIE      ( DMA_SxCR_HTIE )
+#define SIM_TCIE      ( DMA_SxCR_TCIE )
+#define SIM_PSIZE( c ) ( ( SIM_CR( c ) & DMA_SxCR_PSIZE ) >> DMA_SxCR_PSIZE_Pos )
+#define SIM_IS_M2M( c ) \
+  ( ( ( SIM_CR( c ) & DMA_SxCR_DIR ) >> DMA_SxCR_DIR_Pos ) == 2 )
+// In double-buffer mode, 'CT' picks the memory address register.
+static uint32_t sim_mar( int c ) {
+  if ( ( SIM_CR( c ) & DMA_SxCR_DBM ) && ( SIM_CR( c ) & DMA_SxCR_CT ) ) {
+    return SIM_CH[ c ]->M1AR;
+  }
+  return SIM_CH[ c ]->M0AR;
+}
+// At the end of a transfer in double-buffer mode, switch targets.
+static void sim_wrap( int c ) {
+  if ( SIM_CR( c ) & DMA_SxCR_DBM ) { SIM_CR( c ) ^= DMA_SxCR_CT; }
+}
+// Status flags: 'LISR' / 'HISR' with uneven bit offsets, and the
+// matching clear registers.
+static volatile uint32_t *sim_isr( int c ) {
+  DMA_TypeDef *dma = ( c < 8 ) ? DMA1 : DMA2;
+  return ( ( c & 7 ) < 4 ) ? &dma->LISR : &dma->HISR;
+}
+static volatile uint32_t *sim_ifcr( int c ) {
+  DMA_TypeDef *dma = ( c < 8 ) ? DMA1 : DMA2;
+  return ( ( c & 7 ) < 4 ) ? &dma->LIFCR : &dma->HIFCR;
+}
+static uint32_t sim_flag_pos( int c ) {
+  return ( ( c & 1 ) * 6 ) + ( ( c & 2 ) << 3 );
+}
+#define SIM_TC_FLAG( c ) ( 0x20UL << sim_flag_pos( c ) )
+#define SIM_HT_FLAG( c ) ( 0x10UL << sim_flag_pos( c ) )
+#else
+// F3 and G0 chips: one controller with 7 channels.
+#define SIM_WEAK( name ) void name( void ) __attribute__( ( weak ) )
+#define SIM_CHANNELS ( 7 )
+static DMA_Channel_TypeDef *const SIM_CH[ SIM_CHANNELS ] = {
+  DMA1_Channel1, DMA1_Channel2, DMA1_Channel3, DMA1_Channel4,
+  DMA1_Channel5, DMA1_Channel6, DMA1_Channel7
+};
+#if defined( VVC_G0 )
+SIM_WEAK( DMA1_chan1_IRQ_handler );
+SIM_WEAK( DMA1_chan2_3_IRQ_handler );
+SIM_WEAK( DMA1_chan4_5_DMAMUX1_OVR_IRQ_handler );
+static sim_handler_t SIM_IRQ[ SIM_CHANNELS ] = {
+  DMA1_chan1_IRQ_handler, DMA1_chan2_3_IRQ_handler,
+  DMA1_chan2_3_IRQ_handler, DMA1_chan4_5_DMAMUX1_OVR_IRQ_handler,
+  DMA1_chan4_5_DMAMUX1_OVR_IRQ_handler,
+  DMA1_chan4_5_DMAMUX1_OVR_IRQ_handler,
+  DMA1_chan4_5_DMAMUX1_OVR_IRQ_handler
+};
+#else
+SIM_WEAK( DMA1_chan1_IRQ_handler );
+SIM_WEAK( DMA1_chan2_IRQ_handler );
+SIM_WEAK( DMA1_chan3_IRQ_handler );
+SIM_WEAK( DMA1_chan4_IRQ_handler );
+SIM_WEAK( DMA1_chan5_IRQ_handler );
+SIM_WEAK( DMA1_chan6_IRQ_handler );
+SIM_WEAK( DMA1_chan7_IRQ_handler );
+static sim_handler_t SIM_IRQ[ SIM_CHANNELS ] = {
+  DMA1_chan1_IRQ_handler, DMA1_chan2_IRQ_handler,
+  DMA1_chan3_IRQ_handler, DMA1_chan4_IRQ_handler,
+  DMA1_chan5_IRQ_handler, DMA1_chan6_IRQ_handler,
+  DMA1_chan7_IRQ_handler
+};
+#endif
+#define SIM_CR( c )   ( SIM_CH[ c ]->CCR )
+#define SIM_NDTR( c ) ( SIM_CH[ c ]->CNDTR )
+#define SIM_PAR( c )  ( SIM_CH[ c ]->CPAR )
+#define SIM_EN        ( DMA_CCR_EN )
+#define SIM_CIRC      ( DMA_CCR_CIRC )
+#define SIM_MINC      ( DMA_CCR_MINC )
+#define SIM_PINC      ( DMA_CCR_PINC )
+#define SIM_HTIE      ( DMA_CCR_HTIE )
+#define SIM_TCIE      ( DMA_CCR_TCIE )
+#define SIM_PSIZE( c ) ( ( SIM_CR( c ) & DMA_CCR_PSIZE ) >> DMA_CCR_PSIZE_Pos )
+#define SIM_IS_M2M( c ) ( SIM_CR( c ) & DMA_CCR_MEM2MEM )
+static uint32_t sim_mar( int c ) { return SIM_CH[ c ]->CMAR; }
+static void sim_wrap( int c ) { ( void )c; }
+static volatile uint32_t *sim_isr( int c ) { ( void )c; return &DMA1->ISR; }
+static volatile uint32_t *sim_ifcr( int c ) { ( void )c; return &DMA1->IFCR; }
+#define SIM_TC_FLAG( c ) ( 0x2UL << ( 4 * ( c ) ) )
+#define SIM_HT_FLAG( c ) ( 0x4UL << ( 4 * ( c ) ) )
+#endif
+
+// Transfer length of each channel when it was enabled, which is
+// reloaded in circular mode.
+static uint32_t sim_len[ SIM_CHANNELS ];
+static uint8_t  sim_was_on[ SIM_CHANNELS ];
+// Pause after each memory-to-memory transfer.
+static const struct timespec SIM_M2M_PAUSE = { 0, 10000 };
+
+// Copy one item of 1, 2 or 4 bytes.
+static uint32_t sim_read( uint32_t addr, uint32_t size ) {
+  if ( size == 0 ) { return *( volatile uint8_t* )( uintptr_t )addr; }
+  if ( size == 1 ) { return *( volatile uint16_t* )( uintptr_t )addr; }
+  return *( volatile uint32_t* )( uintptr_t )addr;
+}
+static void sim_write( uint32_t addr, uint32_t size, uint32_t val ) {
+  if ( size == 0 ) { *( volatile uint8_t* )( uintptr_t )addr = ( uint8_t )val; }
+  else if ( size == 1 ) { *( volatile uint16_t* )( uintptr_t )addr = ( uint16_t )val; }
+  else { *( volatile uint32_t* )( uintptr_t )addr = val; }
+}
+
+// Set a channel's status flags, and run its interrupt handler if
+// the matching interrupt is enabled. Flags which the handler writes
+// to the clear register are then cleared.
+static void sim_flag( int c, uint32_t flag, uint32_t ie ) {
+  *sim_isr( c ) |= flag;
+  if ( ( SIM_CR( c ) & ie ) && SIM_IRQ[ c ] ) {
+    SIM_IRQ[ c ]();
+    *sim_isr( c ) &= ~( *sim_ifcr( c ) );
+    *sim_ifcr( c ) = 0;
+  }
+}
+
+// Watch for channels being enabled, and run memory-to-memory
+// transfers all at once. Flags which the firmware has written to
+// the clear registers are cleared here too, so they can stay set
+// for a short time after the write.
+static void sim_dma_poll( void ) {
+  for ( int c = 0; c < SIM_CHANNELS; ++c ) {
+    if ( *sim_ifcr( c ) ) {
+      *sim_isr( c ) &= ~( *sim_ifcr( c ) );
+      *sim_ifcr( c ) = 0;
+    }
+    uint8_t on = ( SIM_CR( c ) & SIM_EN ) ? 1 : 0;
+    if ( on && !sim_was_on[ c ] ) { sim_len[ c ] = SIM_NDTR( c ); }
+    sim_was_on[ c ] = on;
+    if ( !on || !SIM_IS_M2M( c ) ) { continue; }
+    uint32_t size = SIM_PSIZE( c );
+    uint32_t n    = SIM_NDTR( c );
+    uint32_t mstep = ( SIM_CR( c ) & SIM_MINC ) ? ( 1UL << size ) : 0;
+    uint32_t pstep = ( SIM_CR( c ) & SIM_PINC ) ? ( 1UL << size ) : 0;
+    for ( uint32_t i = 0; i < n; ++i ) {
+      // (F4 memory-to-memory transfers read from 'PAR'; F3 and G0
+      // ones read from 'CPAR' too, since 'DIR' is 0)
+      sim_write( sim_mar( c ) + ( i * mstep ), size,
+                 sim_read( SIM_PAR( c ) + ( i * pstep ), size ) );
+    }
+    SIM_NDTR( c ) = 0;
+    SIM_CR( c ) &= ~( SIM_EN );
+    sim_was_on[ c ] = 0;
+    sim_flag( c, SIM_TC_FLAG( c ), SIM_TCIE );
+    // Sleep briefly, so that the firmware can see the result if
+    // it is waiting for it. (The host may only have one core)
+    nanosleep( &SIM_M2M_PAUSE, 0 );
+  }
+}
+
+// Move one item on a peripheral channel, and return the value which
+// was written to the peripheral.
+static uint32_t sim_dma_step( int c ) {
+  uint32_t size = SIM_PSIZE( c );
+  uint32_t len  = sim_len[ c ];
+  uint32_t idx  = len - SIM_NDTR( c );
+  uint32_t addr = sim_mar( c );
+  if ( SIM_CR( c ) & SIM_MINC ) { addr += ( idx << size ); }
+  uint32_t val = sim_read( addr, size );
+  sim_write( SIM_PAR( c ), size, val );
+  SIM_NDTR( c ) = SIM_NDTR( c ) - 1;
+  if ( SIM_NDTR( c ) == ( len / 2 ) ) {
+    sim_flag( c, SIM_HT_FLAG( c ), SIM_HTIE );
+  }
+  if ( SIM_NDTR( c ) == 0 ) {
+    if ( SIM_CR( c ) & SIM_CIRC ) {
+      SIM_NDTR( c ) = len;
+      sim_wrap( c );
+    }
+    else {
+      SIM_CR( c ) &= ~( SIM_EN );
+    }
+    sim_flag( c, SIM_TC_FLAG( c ), SIM_TCIE );
+  }
+  return val;
+}
+
+// Report the PLL as locked once it is enabled, and the system
+// clock as switched once it is selected. (The firmware is waiting
+// for these bits whenever they differ, so it is not also writing
+// the registers)
+static void sim_rcc_poll( void ) {
+  if ( ( RCC->CR & RCC_CR_PLLON ) && !( RCC->CR & RCC_CR_PLLRDY ) ) {
+    RCC->CR |= RCC_CR_PLLRDY;
+  }
+  uint32_t sw  = ( RCC->CFGR & RCC_CFGR_SW ) >> RCC_CFGR_SW_Pos;
+  uint32_t sws = ( RCC->CFGR & RCC_CFGR_SWS ) >> RCC_CFGR_SWS_Pos;
+  if ( sw != sws ) {
+    RCC->CFGR = ( RCC->CFGR & ~( RCC_CFGR_SWS ) ) |
+                ( sw << RCC_CFGR_SWS_Pos );
+  }
+}
+
+// Find the channel which feeds the DAC's data register. Returns -1
+// if none is running yet, and sets 'stereo' if it writes to the
+// dual-channel register.
+static int sim_dac_channel( int *stereo ) {
+  for ( int c = 0; c < SIM_CHANNELS; ++c ) {
+    if ( !( SIM_CR( c ) & SIM_EN ) ) { continue; }
+    if ( SIM_PAR( c ) == ( uint32_t )( uintptr_t )&( DAC1->DHR12RD ) ) {
+      *stereo = 1;
+      return c;
+    }
+    if ( SIM_PAR( c ) == ( uint32_t )( uintptr_t )&( DAC1->DHR12R1 ) ) {
+      *stereo = 0;
+      return c;
+    }
+  }
+  return -1;
+}
+
+// Write a 16-bit PCM WAV header.
+static void wav_header( FILE *f, uint32_t rate, uint16_t chans,
+                        uint32_t frames ) {
+  uint32_t data  = frames * chans * 2;
+  uint32_t riff  = 36 + data;
+  uint32_t bps   = rate * chans * 2;
+  uint16_t align = chans * 2;
+  uint32_t fmt_len = 16;
+  uint16_t pcm = 1, bits = 16;
+  fwrite( "RIFF", 1, 4, f ); fwrite( &riff, 4, 1, f );
+  fwrite( "WAVEfmt ", 1, 8, f ); fwrite( &fmt_len, 4, 1, f );
+  fwrite( &pcm, 2, 1, f ); fwrite( &chans, 2, 1, f );
+  fwrite( &rate, 4, 1, f ); fwrite( &bps, 4, 1, f );
+  fwrite( &align, 2, 1, f ); fwrite( &bits, 2, 1, f );
+  fwrite( "data", 1, 4, f ); fwrite( &data, 4, 1, f );
+}
+
+// Back the peripheral and core register ranges with memory.
+// Returns 0 on success, or -1 if they could not be mapped.
+static int sim_map( void ) {
+  if ( mmap( ( void* )SIM_PERIPH_START, SIM_PERIPH_SIZE,
+             PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE,
+             -1, 0 ) != ( void* )SIM_PERIPH_START ||
+       mmap( ( void* )SIM_CORE_START, SIM_CORE_SIZE,
+             PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE,
+             -1, 0 ) != ( void* )SIM_CORE_START ) {
+    perror( "Could not map the peripheral registers" );
+    return -1;
+  }
+  return 0;
+}
+
+static void *firmware_thread( void *arg ) {
+  ( void )arg;
+  firmware_main();
+  return 0;
+}
+
+// Usage: host_sim <output.wav> <seconds>
+int main( int argc, char **argv ) {
+  if ( argc != 3 ) {
+    fprintf( stderr, "Usage: %s <output.wav> <seconds>\n", argv[ 0 ] );
+    return 1;
+  }
+  if ( sim_map() ) { return 1; }
+  pthread_t fw;
+  pthread_create( &fw, 0, firmware_thread, 0 );
+
+  // Wait for the DAC, its trigger timer, and its DMA channel.
+  int stereo = 0;
+  int c = -1;
+  while ( c < 0 || !( TIM6->CR1 & TIM_CR1_CEN ) ||
+          !( DAC1->CR & DAC_CR_TEN1 ) ) {
+    sim_rcc_poll();
+    sim_dma_poll();
+    c = sim_dac_channel( &stereo );
+  }
+  uint32_t rate = clock_tim_hz() /
+                  ( ( TIM6->PSC + 1 ) * ( TIM6->ARR + 1 ) );
+  uint32_t frames = rate * ( uint32_t )atoi( argv[ 2 ] );
+  FILE *f = fopen( argv[ 1 ], "wb" );
+  if ( !f ) {
+    perror( argv[ 1 ] );
+    return 1;
+  }
+  uint16_t chans = stereo ? 2 : 1;
+  wav_header( f, rate, chans, frames );
+  for ( uint32_t i = 0; i < frames; ++i ) {
+    sim_dma_poll();
+    uint32_t v = sim_dma_step( c );
+    int16_t out[ 2 ] = {
+      ( int16_t )( ( ( int32_t )( v & 0xFFF ) - 2048 ) * 16 ),
+      ( int16_t )( ( ( int32_t )( ( v >> 16 ) & 0xFFF ) - 2048 ) * 16 )
+    };
+    fwrite( out, 2, chans, f );
+  }
+  fclose( f );
+  printf( "Core clock: %u Hz, timers: %u Hz\n", SystemCoreClock,
+          clock_tim_hz() );
+  printf( "%u Hz, %u channel(s), %u samples\n", rate, chans, frames );
+  printf( "Underruns: %u, worst refill: %u cycles\n",
+          audio_underruns, audio_worst_cycles );
+  for ( size_t i = 0; i < bench_num; ++i ) {
+    const bench_t *b = &bench_results[ i ];
+    printf( "%-12s runs: %6u  min: %8u  avg: %8u  max: %8u\n",
+            b->name, b->runs, b->min,
+            ( uint32_t )( b->total / b->runs ), b->max );
+  }
+  // (The firmware thread never returns)
+  exit( 0 );
+}
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Encode a PCM WAV file as an IMA-ADPCM clip, and write it out as
+# a C source file which defines an 'adpcm_clip_t' (see src/adpcm.h).
+#
+# Usage: wav2adpcm.py <input.wav> <CLIP_NAME> [output.c]
+#
+# Stereo files are mixed down to mono, and 8-bit files are scaled up
+# to 16 bits. The clip keeps the WAV file's sample rate. After
+# encoding, the clip is decoded again with the same algorithm as the
+# firmware and the signal-to-noise ratio is printed, as a check.
+import math
+import sys
+import wave
+
+STEPS = [
+      7,     8,     9,    10,    11,    12,    13,    14,
+     16,    17,    19,    21,    23,    25,    28,    31,
+     34,    37,    41,    45,    50,    55,    60,    66,
+     73,    80,    88,    97,   107,   118,   130,   143,
+    157,   173,   190,   209,   230,   253,   279,   307,
+    337,   371,   408,   449,   494,   544,   598,   658,
+    724,   796,   876,   963,  1060,  1166,  1282,  1411,
+   1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,
+   3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,
+   7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767
+]
+INDEX = [ -1, -1, -1, -1, 2, 4, 6, 8 ]
+
+def read_wav( path ):
+  with wave.open( path, 'rb' ) as w:
+    chans = w.getnchannels()
+    width = w.getsampwidth()
+    rate  = w.getframerate()
+    raw   = w.readframes( w.getnframes() )
+  if width == 1:
+    vals = [ ( b - 128 ) << 8 for b in raw ]
+  elif width == 2:
+    vals = [ int.from_bytes( raw[ i:i + 2 ], 'little', signed=True )
+             for i in range( 0, len( raw ), 2 ) ]
+  else:
+    sys.exit( 'Only 8-bit and 16-bit PCM WAV files are supported.' )
+  mono = [ sum( vals[ i:i + chans ] ) // chans
+           for i in range( 0, len( vals ), chans ) ]
+  return mono, rate
+
+# Apply one code to the decoder state, exactly like 'adpcm_fill'.
+def decode_step( pred, index, code ):
+  step = STEPS[ index ]
+  diff = step >> 3
+  if code & 0x4: diff += step
+  if code & 0x2: diff += step >> 1
+  if code & 0x1: diff += step >> 2
+  pred = pred - diff if code & 0x8 else pred + diff
+  pred = max( -32768, min( 32767, pred ) )
+  index = max( 0, min( 88, index + INDEX[ code & 0x7 ] ) )
+  return pred, index
+
+def encode( samples ):
+  pred0 = samples[ 0 ] if samples else 0
+  # Start with the step size closest to the first change.
+  first = abs( samples[ 1 ] - samples[ 0 ] ) if len( samples ) > 1 else 0
+  index0 = min( range( 89 ), key=lambda i: abs( STEPS[ i ] - first ) )
+  pred, index = pred0, index0
+  codes = []
+  out = []
+  for s in samples:
+    step = STEPS[ index ]
+    diff = s - pred
+    code = 0
+    if diff < 0:
+      code = 0x8
+      diff = -diff
+    if diff >= step:
+      code |= 0x4
+      diff -= step
+    if diff >= ( step >> 1 ):
+      code |= 0x2
+      diff -= ( step >> 1 )
+    if diff >= ( step >> 2 ):
+      code |= 0x1
+    pred, index = decode_step( pred, index, code )
+    codes.append( code )
+    out.append( pred )
+  return codes, out, pred0, index0
+
+def snr_db( ref, out ):
+  sig = sum( s * s for s in ref )
+  err = sum( ( a - b ) ** 2 for a, b in zip( ref, out ) )
+  if err == 0: return float( 'inf' )
+  if sig == 0: return float( '-inf' )
+  return 10 * math.log10( sig / err )
+
+def main():
+  if len( sys.argv ) not in ( 3, 4 ):
+    sys.exit( 'Usage: %s <input.wav> <CLIP_NAME> [output.c]' % sys.argv[ 0 ] )
+  path, name = sys.argv[ 1 ], sys.argv[ 2 ]
+  samples, rate = read_wav( path )
+  if not samples:
+    sys.exit( 'No samples in %s.' % path )
+  codes, out, pred0, index0 = encode( samples )
+  if len( codes ) & 1: codes.append( 0 )
+  data = [ codes[ i ] | ( codes[ i + 1 ] << 4 )
+           for i in range( 0, len( codes ), 2 ) ]
+
+  lines = [ '// Generated by tools/wav2adpcm.py from \'%s\'; do not edit.'
+            % path.split( '/' )[ -1 ],
+            '#include "adpcm.h"',
+            '',
+            '// %d samples at %dHz, in %d bytes.' % ( len( samples ), rate, len( data ) ),
+            'static const uint8_t %s_DATA[ %d ] = {' % ( name, len( data ) ) ]
+  for i in range( 0, len( data ), 12 ):
+    row = ', '.join( '0x%02X' % b for b in data[ i:i + 12 ] )
+    lines.append( '  ' + row + ( ',' if i + 12 < len( data ) else '' ) )
+  lines += [ '};',
+             '',
+             'const adpcm_clip_t %s = {' % name,
+             '  %s_DATA, %d, %d, %d, %d' % ( name, len( samples ), rate, pred0, index0 ),
+             '};',
+             '' ]
+  src = '\n'.join( lines )
+  if len( sys.argv ) == 4:
+    with open( sys.argv[ 3 ], 'w' ) as f:
+      f.write( src )
+  else:
+    sys.stdout.write( src )
+  sys.stderr.write( '%s: %d samples, %d bytes, SNR %.1fdB\n' %
+                    ( name, len( samples ), len( data ), snr_db( samples, out ) ) )
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,82 @@
+#include "adpcm.h"
+#include "sections.h"
+
+// Quantizer step sizes, from the IMA-ADPCM specification.
+static const int16_t ADPCM_STEPS[ 89 ] = {
+      7,     8,     9,    10,    11,    12,    13,    14,
+     16,    17,    19,    21,    23,    25,    28,    31,
+     34,    37,    41,    45,    50,    55,    60,    66,
+     73,    80,    88,    97,   107,   118,   130,   143,
+    157,   173,   190,   209,   230,   253,   279,   307,
+    337,   371,   408,   449,   494,   544,   598,   658,
+    724,   796,   876,   963,  1060,  1166,  1282,  1411,
+   1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,
+   3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,
+   7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767
+};
+
+// Step size index adjustments, for each code's magnitude bits.
+static const int8_t ADPCM_INDEX[ 8 ] = {
+  -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+// Start playing a clip from the beginning.
+void adpcm_start( adpcm_t *dec, const adpcm_clip_t *clip, uint8_t loop ) {
+  dec->clip  = clip;
+  dec->pos   = 0;
+  dec->pred  = clip->pred;
+  dec->index = clip->index;
+  dec->loop  = loop;
+}
+
+// Decode the next 'len' samples into a buffer of unsigned 12-bit
+// DAC values, centered on 2048. After a clip which does not loop
+// has ended, the rest of the buffer is filled with silence.
+// Returns the number of samples which were decoded from the clip.
+RAMFUNC size_t adpcm_fill( adpcm_t *dec, uint16_t *buf, size_t len ) {
+  const adpcm_clip_t *clip = dec->clip;
+  size_t i = 0;
+  if ( clip ) {
+    uint32_t pos   = dec->pos;
+    int32_t  pred  = dec->pred;
+    int32_t  index = dec->index;
+    while ( i < len ) {
+      if ( pos >= clip->len ) {
+        if ( !dec->loop ) {
+          dec->clip = 0;
+          break;
+        }
+        pos   = 0;
+        pred  = clip->pred;
+        index = clip->index;
+      }
+      uint32_t code = clip->data[ pos >> 1 ];
+      if ( pos & 1 ) { code >>= 4; }
+      // Each code holds a sign bit and a 3-bit magnitude, which
+      // add up fractions of the current step size.
+      int32_t step = ADPCM_STEPS[ index ];
+      int32_t diff = step >> 3;
+      if ( code & 0x4 ) { diff += step; }
+      if ( code & 0x2 ) { diff += ( step >> 1 ); }
+      if ( code & 0x1 ) { diff += ( step >> 2 ); }
+      if ( code & 0x8 ) { pred -= diff; }
+      else              { pred += diff; }
+      if ( pred > 32767 ) { pred = 32767; }
+      else if ( pred < -32768 ) { pred = -32768; }
+      index += ADPCM_INDEX[ code & 0x7 ];
+      if ( index < 0 ) { index = 0; }
+      else if ( index > 88 ) { index = 88; }
+      // Keep the top 12 bits of the 16-bit sample.
+      buf[ i++ ] = ( uint16_t )( 2048 + ( pred >> 4 ) );
+      ++pos;
+    }
+    dec->pos   = pos;
+    dec->pred  = pred;
+    dec->index = index;
+  }
+  size_t decoded = i;
+  for ( ; i < len; ++i ) { buf[ i ] = 2048; }
+  return decoded;
+}
@@ -0,0 +1,128 @@
+#include "mixer.h"
+#include "sections.h"
+
+// Vendor-provided device header file, for the core's intrinsics.
+#if defined( VVC_F3 )
+  #include "stm32f3xx.h"
+#elif defined( VVC_F4 )
+  #include "stm32f4xx.h"
+#elif defined( VVC_G0 )
+  #include "stm32g0xx.h"
+#endif
+
+// Cortex-M4 cores have packed 16-bit 'SIMD' instructions.
+// (Host builds use the plain C loops)
+#if ( __CORTEX_M >= 0x04U ) && !defined( VVC_HOST )
+  #define MIX_SIMD ( 1 )
+#else
+  #define MIX_SIMD ( 0 )
+#endif
+
+// Shift which turns a phase accumulator into a table index.
+#define MIX_SHIFT ( 32 - DDS_TABLE_BITS )
+
+// Sum of every voice for each sample in the current block, in
+// units of 1/32768 of a DAC count. Full-scale samples at full
+// volume add up to less than 2^26, so 32 voices cannot overflow.
+// (Cubic interpolation can overshoot a sample by up to a quarter,
+// so count those sample voices as 1.25 voices each)
+static int32_t MIX_ACC[ MIX_MAX_BLOCK ];
+
+// Convert an oscillator's volume (out of 256) to Q15.
+static inline RAMFUNC int32_t mix_vol_q15( const dds_t *voice ) {
+  return ( voice->amp >= 256 ) ? 0x7FFF : ( ( int32_t )voice->amp << 7 );
+}
+
+// Mix up to 'MIX_MAX_BLOCK' samples.
+static RAMFUNC void mix_block( dds_t *voices, size_t num,
+                               rs_voice_t *samples, size_t num_samples,
+                               uint16_t *buf, size_t len ) {
+  size_t v = 0;
+  size_t i = 0;
+  for ( i = 0; i < len; ++i ) { MIX_ACC[ i ] = 0; }
+#if MIX_SIMD
+  // Add voices two at a time: each sample from the pair is
+  // packed into one word, and 'SMLAD' multiplies both halves by
+  // their packed volumes and adds both products to the sum.
+  for ( ; v + 1 < num; v += 2 ) {
+    dds_t *a = &voices[ v ];
+    dds_t *b = &voices[ v + 1 ];
+    const int16_t *table_a = a->table;
+    const int16_t *table_b = b->table;
+    uint32_t phase_a = a->phase;
+    uint32_t phase_b = b->phase;
+    uint32_t step_a  = a->step;
+    uint32_t step_b  = b->step;
+    uint32_t vols = __PKHBT( mix_vol_q15( a ), mix_vol_q15( b ), 16 );
+    for ( i = 0; i < len; ++i ) {
+      uint32_t s = __PKHBT( table_a[ phase_a >> MIX_SHIFT ],
+                            table_b[ phase_b >> MIX_SHIFT ], 16 );
+      MIX_ACC[ i ] = ( int32_t )__SMLAD( s, vols, ( uint32_t )MIX_ACC[ i ] );
+      phase_a += step_a;
+      phase_b += step_b;
+    }
+    a->phase = phase_a;
+    b->phase = phase_b;
+  }
+#endif
+  // Add any remaining voices one at a time.
+  for ( ; v < num; ++v ) {
+    dds_t *a = &voices[ v ];
+    const int16_t *table_a = a->table;
+    uint32_t phase_a = a->phase;
+    uint32_t step_a  = a->step;
+    int32_t vol = mix_vol_q15( a );
+    for ( i = 0; i < len; ++i ) {
+      MIX_ACC[ i ] += table_a[ phase_a >> MIX_SHIFT ] * vol;
+      phase_a += step_a;
+    }
+    a->phase = phase_a;
+  }
+  // Add the resampled voices.
+  for ( v = 0; v < num_samples; ++v ) {
+    rs_add( &samples[ v ], MIX_ACC, len );
+  }
+
+  i = 0;
+#if MIX_SIMD
+  // Saturate two samples to signed 12 bits, pack them into one
+  // word, and re-center both on 2048 with one 'QADD16'. Then
+  // both DAC values can be stored with one 32-bit write.
+  if ( ( ( uint32_t )buf & 0x3 ) == 0 ) {
+    uint32_t *buf2 = ( uint32_t* )buf;
+    for ( ; i + 1 < len; i += 2 ) {
+      int32_t s0 = __SSAT( MIX_ACC[ i ] >> 15, 12 );
+      int32_t s1 = __SSAT( MIX_ACC[ i + 1 ] >> 15, 12 );
+      buf2[ i / 2 ] = __QADD16( __PKHBT( s0, s1, 16 ), 0x08000800 );
+    }
+  }
+#endif
+  for ( ; i < len; ++i ) {
+    int32_t s = MIX_ACC[ i ] >> 15;
+    if ( s > 2047 ) { s = 2047; }
+    else if ( s < -2048 ) { s = -2048; }
+    buf[ i ] = ( uint16_t )( 2048 + s );
+  }
+}
+
+// Mix the next 'len' samples from 'num' oscillators into a
+// buffer of unsigned 12-bit DAC values, centered on 2048. Each
+// oscillator's 'amp' sets its volume, and the sum is clipped to
+// the DAC's range. Word-aligned buffers are written two samples
+// at a time on Cortex-M4 cores.
+RAMFUNC void mix_fill( dds_t *voices, size_t num, uint16_t *buf, size_t len ) {
+  mix_fill_samples( voices, num, 0, 0, buf, len );
+}
+
+// Mix oscillators and recorded samples together. Each sample
+// voice is resampled to its own pitch, at the same output rate.
+RAMFUNC void mix_fill_samples( dds_t *voices, size_t num,
+                               rs_voice_t *samples, size_t num_samples,
+                               uint16_t *buf, size_t len ) {
+  while ( len > MIX_MAX_BLOCK ) {
+    mix_block( voices, num, samples, num_samples, buf, MIX_MAX_BLOCK );
+    buf += MIX_MAX_BLOCK;
+    len -= MIX_MAX_BLOCK;
+  }
+  mix_block( voices, num, samples, num_samples, buf, len );
+}
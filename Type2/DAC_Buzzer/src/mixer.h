@@ -0,0 +1,19 @@
+#ifndef __VVC_MIXER_H
+#define __VVC_MIXER_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+// Project includes.
+#include "dds.h"
+#include "resample.h"
+
+// Most samples which can be mixed in one call.
+#define MIX_MAX_BLOCK ( 256 )
+
+void mix_fill( dds_t *voices, size_t num, uint16_t *buf, size_t len );
+void mix_fill_samples( dds_t *voices, size_t num,
+                       rs_voice_t *samples, size_t num_samples,
+                       uint16_t *buf, size_t len );
+
+#endif
@@ -0,0 +1,196 @@
+#include "seq.h"
+#include "mixer.h"
+
+// Envelope level at full volume.
+#define SEQ_FULL ( 1 << 24 )
+
+// Frequencies of MIDI notes 120-131, in 16.16 fixed-point Hertz.
+// Each octave below these is half of the one above it.
+static const uint32_t SEQ_NOTE_HZ[ 12 ] = {
+  548668578, 581294109, 615859655, 652480576,
+  691279090, 732384684, 775934544, 822074013,
+  870957077, 922746880, 977616265, 1035748353
+};
+
+// Find the frequency of a MIDI note, in 16.16 fixed-point Hertz.
+static uint32_t seq_note_hz( uint8_t note ) {
+  uint32_t shift = 10 - ( note / 12 );
+  return ( SEQ_NOTE_HZ[ note % 12 ] + ( ( 1 << shift ) >> 1 ) ) >> shift;
+}
+
+// Convert a time in milliseconds to a number of samples (at
+// least one). ( rate / 8 ) keeps the product within 32 bits.
+static int32_t seq_ms( seq_t *seq, uint16_t ms ) {
+  int32_t n = ( int32_t )( ( ms * ( seq->rate / 8 ) ) / 125 );
+  return ( n > 0 ) ? n : 1;
+}
+
+// Number of samples per tick, at the song's tempo.
+static uint32_t seq_tick_len( const seq_song_t *song, uint32_t rate ) {
+  return ( rate * 60 ) / ( ( uint32_t )song->bpm * song->tpb );
+}
+
+// Start releasing a track's current note.
+static void seq_release( seq_t *seq, seq_track_state_t *t ) {
+  if ( t->env_state == SEQ_ENV_OFF ||
+       t->env_state == SEQ_ENV_RELEASE ) { return; }
+  t->env_state = SEQ_ENV_RELEASE;
+  t->inc = -( t->level / seq_ms( seq, t->env->release_ms ) );
+  if ( t->inc == 0 ) { t->inc = -1; }
+}
+
+// Start playing a note on one track. The oscillator's phase and
+// the envelope's level both carry on from the last note, so a
+// note which cuts the previous one off does not click.
+static void seq_note_on( seq_t *seq, size_t i, const seq_event_t *ev ) {
+  seq_track_state_t *t = &seq->tracks[ i ];
+  t->env = &seq->song->envs[ ev->env ];
+  dds_set_freq( &seq->voices[ i ], seq_note_hz( ev->note ) );
+  t->env_state = SEQ_ENV_ATTACK;
+  t->inc = SEQ_FULL / seq_ms( seq, t->env->attack_ms );
+}
+
+// Start any events which are due on one track.
+static void seq_advance( seq_t *seq, size_t i ) {
+  seq_track_state_t *t = &seq->tracks[ i ];
+  const seq_event_t *events = seq->song->tracks[ i ].events;
+  while ( !t->done && t->left <= 0 ) {
+    const seq_event_t *ev = &events[ t->ev ];
+    if ( ev->note == SEQ_END ) {
+      t->done = 1;
+      seq_release( seq, t );
+      break;
+    }
+    // ( 'left' can be slightly below zero, because events only
+    // start on control boundaries; the next event is shortened
+    // to make up for it, so the timing does not drift )
+    int32_t start = t->left;
+    int32_t len   = ( int32_t )( ev->ticks * seq->tick_len );
+    t->left += len;
+    if ( ev->note == SEQ_REST ) {
+      t->gate_left = t->left;
+      seq_release( seq, t );
+    }
+    else {
+      seq_note_on( seq, i, ev );
+      t->gate_left = start +
+        ( int32_t )( ( ( int64_t )len * t->env->gate ) >> 8 );
+    }
+    ++t->ev;
+  }
+}
+
+// Move a track's envelope forward by 'n' samples.
+static void seq_env_step( seq_t *seq, seq_track_state_t *t, int32_t n ) {
+  int32_t sustain = ( int32_t )t->env->sustain * ( SEQ_FULL / 255 );
+  switch ( t->env_state ) {
+    case SEQ_ENV_ATTACK:
+      t->level += t->inc * n;
+      if ( t->level >= SEQ_FULL ) {
+        t->level     = SEQ_FULL;
+        t->env_state = SEQ_ENV_DECAY;
+        t->inc = -( ( SEQ_FULL - sustain ) / seq_ms( seq, t->env->decay_ms ) );
+        if ( t->inc == 0 ) { t->inc = -1; }
+      }
+      break;
+    case SEQ_ENV_DECAY:
+      t->level += t->inc * n;
+      if ( t->level <= sustain ) {
+        t->level     = sustain;
+        t->env_state = SEQ_ENV_SUSTAIN;
+      }
+      break;
+    case SEQ_ENV_RELEASE:
+      t->level += t->inc * n;
+      if ( t->level <= 0 ) {
+        t->level     = 0;
+        t->env_state = SEQ_ENV_OFF;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// Start playing a song from the beginning, at 'rate' samples
+// per second.
+void seq_start( seq_t *seq, const seq_song_t *song, uint32_t rate ) {
+  seq->song     = song;
+  seq->rate     = rate;
+  seq->tick_len = seq_tick_len( song, rate );
+  seq->playing  = 1;
+  for ( size_t i = 0; i < SEQ_MAX_TRACKS; ++i ) {
+    seq_track_state_t *t = &seq->tracks[ i ];
+    t->ev        = 0;
+    t->left      = 0;
+    t->gate_left = 0;
+    t->env_state = SEQ_ENV_OFF;
+    t->done      = ( i >= song->num_tracks );
+    t->env       = &song->envs[ 0 ];
+    t->level     = 0;
+    t->inc       = 0;
+    dds_init( &seq->voices[ i ], rate );
+    seq->voices[ i ].amp = 0;
+    if ( i < song->num_tracks ) {
+      seq->voices[ i ].table = song->tracks[ i ].table;
+    }
+  }
+}
+
+// Change the output sample rate, keeping the same pitch and
+// tempo. Notes which are playing keep their timing.
+void seq_set_rate( seq_t *seq, uint32_t rate ) {
+  if ( !seq->song || rate == seq->rate ) { return; }
+  for ( size_t i = 0; i < SEQ_MAX_TRACKS; ++i ) {
+    seq_track_state_t *t = &seq->tracks[ i ];
+    t->left      = ( int32_t )( ( ( int64_t )t->left * rate ) / seq->rate );
+    t->gate_left = ( int32_t )( ( ( int64_t )t->gate_left * rate ) / seq->rate );
+    t->inc       = ( int32_t )( ( ( int64_t )t->inc * seq->rate ) / rate );
+    dds_set_rate( &seq->voices[ i ], rate );
+  }
+  seq->rate     = rate;
+  seq->tick_len = seq_tick_len( seq->song, rate );
+}
+
+// Play the next 'len' samples of the song into a buffer of
+// unsigned 12-bit DAC values, centered on 2048. Events and
+// envelopes are updated every 'SEQ_CTRL_LEN' samples.
+void seq_fill( seq_t *seq, uint16_t *buf, size_t len ) {
+  size_t num = seq->song ? seq->song->num_tracks : 0;
+  while ( len ) {
+    int32_t n = ( len < SEQ_CTRL_LEN ) ? ( int32_t )len : SEQ_CTRL_LEN;
+    uint8_t active = 0;
+    for ( size_t i = 0; i < num; ++i ) {
+      seq_advance( seq, i );
+      if ( !seq->tracks[ i ].done ) { active = 1; }
+    }
+    // Once every track has ended, start again or stop.
+    if ( !active && seq->playing ) {
+      if ( seq->song->loop ) {
+        for ( size_t i = 0; i < num; ++i ) {
+          seq->tracks[ i ].ev   = 0;
+          seq->tracks[ i ].done = 0;
+          seq_advance( seq, i );
+        }
+      }
+      else { seq->playing = 0; }
+    }
+    for ( size_t i = 0; i < num; ++i ) {
+      seq_track_state_t *t = &seq->tracks[ i ];
+      if ( t->gate_left <= 0 ) { seq_release( seq, t ); }
+      seq_env_step( seq, t, n );
+      seq->voices[ i ].amp = ( uint16_t )(
+        ( ( t->level >> 16 ) * seq->song->tracks[ i ].amp ) >> 8 );
+    }
+    mix_fill( seq->voices, num, buf, n );
+    // (Ended tracks keep their timing, so a looping song starts
+    // its tracks again together if they all have the same length)
+    for ( size_t i = 0; i < num; ++i ) {
+      if ( seq->tracks[ i ].done ) { continue; }
+      seq->tracks[ i ].left      -= n;
+      seq->tracks[ i ].gate_left -= n;
+    }
+    buf += n;
+    len -= n;
+  }
+}
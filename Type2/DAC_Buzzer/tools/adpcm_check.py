@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Compare the firmware's IMA-ADPCM decoder against Python's 'audioop'
+# module, which has its own implementation of the standard decoder.
+#
+# Usage: adpcm_check.py <file from tools/adpcm_test>
+#
+# Each clip's codes are decoded with 'audioop.adpcm2lin', and the
+# 16-bit result is cut down to the firmware's 12-bit DAC values.
+# Every sample must match to within 1 LSB. ('audioop' packs the
+# first code of each byte in the high nibble, so the nibbles are
+# swapped first) 'audioop' was removed in Python 3.13.
+import struct
+import sys
+import warnings
+
+with warnings.catch_warnings():
+  warnings.simplefilter( 'ignore', DeprecationWarning )
+  try:
+    import audioop
+  except ImportError:
+    sys.exit( 'This check needs the \'audioop\' module (Python 3.12 or older).' )
+
+def main():
+  if len( sys.argv ) != 2:
+    sys.exit( 'Usage: %s <file from tools/adpcm_test>' % sys.argv[ 0 ] )
+  with open( sys.argv[ 1 ], 'rb' ) as f:
+    raw = f.read()
+  pos = 0
+  fails = 0
+  clip = 0
+  while pos < len( raw ):
+    n, pred, index, _ = struct.unpack_from( '<IhBB', raw, pos )
+    pos += 8
+    nbytes = ( n + 1 ) // 2
+    codes = raw[ pos:pos + nbytes ]
+    pos += nbytes
+    dac = struct.unpack_from( '<%dH' % n, raw, pos )
+    pos += 2 * n
+    swapped = bytes( ( ( b & 0x0F ) << 4 ) | ( b >> 4 ) for b in codes )
+    pcm, _ = audioop.adpcm2lin( swapped, 2, ( pred, index ) )
+    ref = [ 2048 + ( s >> 4 ) for s in struct.unpack( '<%dh' % ( nbytes * 2 ), pcm )[ :n ] ]
+    worst = max( abs( a - b ) for a, b in zip( dac, ref ) )
+    bad = sum( 1 for a, b in zip( dac, ref ) if abs( a - b ) > 1 )
+    print( 'clip %d: %d samples, worst difference %d LSB, %d over 1 LSB' %
+           ( clip, n, worst, bad ) )
+    if bad: fails += 1
+    clip += 1
+  print( '%d failure(s)' % fails )
+  sys.exit( 1 if fails else 0 )
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,157 @@
+// Check the double-buffer refill protocol on the host machine.
+// Build and run it with 'make dbm-test'.
+//
+// The firmware is started in the simulator from 'host_sim.c', and
+// once its DAC stream is running, this takes over the stream and
+// steps it through a series of 'transfer complete' events. Its
+// block producer is replaced with one which tags each block, so
+// the test can check which buffer every refill writes, what DMA
+// plays afterwards, and when 'audio_underruns' goes up:
+// - Refills which run as soon as DMA switches targets.
+// - A refill which runs late, but before the target finishes.
+// - A refill which takes longer than a whole target.
+// - A refill which runs after DMA has switched targets twice.
+// Returns non-zero if any check fails.
+#define main host_sim_main
+#include "host_sim.c"
+#undef main
+
+// Firmware symbols.
+typedef const void *( *test_block_producer_t )( void *buf, size_t len );
+extern test_block_producer_t audio_block_producer;
+void DMA_Stream5_IRQ_handler( void );
+
+// DAC stream, its target length, and its two buffers.
+static int      dac_c;
+static uint32_t dac_len;
+static uint32_t buf_a, buf_b;
+// Tag which the producer writes to every sample of a block, and
+// the buffer which it was last given.
+static uint32_t tag = 0x100;
+static uint32_t given;
+// Samples for the producer to play through before it returns,
+// to simulate a refill which takes too long.
+static uint32_t slow = 0;
+static int fails = 0;
+
+#define CHECK( cond, ... ) do { \
+  if ( !( cond ) ) { printf( "FAIL: " __VA_ARGS__ ); printf( "\n" ); ++fails; } \
+} while ( 0 )
+
+// Step the stream by 'n' samples. Returns the last sample played.
+static uint32_t play( uint32_t n ) {
+  uint32_t v = 0;
+  for ( uint32_t i = 0; i < n; ++i ) {
+    sim_dma_poll();
+    v = sim_dma_step( dac_c );
+  }
+  return v;
+}
+
+// Run the stream's interrupt handler if its 'transfer complete'
+// flag is set. The simulator's own interrupt calls are turned off,
+// so the test decides when each interrupt runs.
+static void irq_run( void ) {
+  if ( *sim_isr( dac_c ) & SIM_TC_FLAG( dac_c ) ) {
+    DMA_Stream5_IRQ_handler();
+    *sim_isr( dac_c ) &= ~( *sim_ifcr( dac_c ) );
+    *sim_ifcr( dac_c ) = 0;
+  }
+}
+
+static const void *test_producer( void *buf, size_t len ) {
+  uint32_t size = SIM_PSIZE( dac_c );
+  given = ( uint32_t )( uintptr_t )buf;
+  for ( size_t i = 0; i < len; ++i ) {
+    sim_write( given + ( i << size ), size, tag );
+  }
+  play( slow );
+  return buf;
+}
+
+// Run one refill with a new tag, and check that it filled the idle
+// buffer, and that the underrun count went up by 'under'.
+static void check_refill( const char *name, uint32_t under ) {
+  uint32_t ct     = SIM_CR( dac_c ) & DMA_SxCR_CT;
+  uint32_t was    = audio_underruns;
+  uint32_t expect = ct ? buf_a : buf_b;
+  ++tag;
+  given = 0;
+  irq_run();
+  CHECK( given == expect, "%s: refill wrote 0x%08X, expected 0x%08X",
+         name, given, expect );
+  CHECK( ( ct ? SIM_CH[ dac_c ]->M0AR : SIM_CH[ dac_c ]->M1AR ) == expect,
+         "%s: idle address register was not set", name );
+  CHECK( audio_underruns - was == under, "%s: %u underrun(s), expected %u",
+         name, audio_underruns - was, under );
+  printf( "%-14s CT=%u  wrote %s  underruns: %u\n", name, ct ? 1 : 0,
+          ( given == buf_a ) ? "M0AR" : "M1AR", audio_underruns );
+}
+
+int main( void ) {
+  if ( sim_map() ) { return 1; }
+  pthread_t fw;
+  pthread_create( &fw, 0, firmware_thread, 0 );
+  int stereo = 0;
+  dac_c = -1;
+  while ( dac_c < 0 || !( TIM6->CR1 & TIM_CR1_CEN ) ||
+          !( DAC1->CR & DAC_CR_TEN1 ) ) {
+    sim_rcc_poll();
+    sim_dma_poll();
+    dac_c = sim_dac_channel( &stereo );
+  }
+  if ( !( SIM_CR( dac_c ) & DMA_SxCR_DBM ) ) {
+    printf( "The DAC stream is not in double-buffer mode.\n" );
+    return 1;
+  }
+  // (Record the stream's length, if it was only just enabled)
+  sim_dma_poll();
+  dac_len = sim_len[ dac_c ];
+  buf_a   = SIM_CH[ dac_c ]->M0AR;
+  buf_b   = SIM_CH[ dac_c ]->M1AR;
+  audio_block_producer = test_producer;
+  audio_underruns = 0;
+  SIM_IRQ[ dac_c ] = 0;
+
+  // Refills which run as soon as each target finishes. Each block
+  // is played in full after the next target.
+  play( dac_len );
+  for ( int i = 0; i < 4; ++i ) {
+    check_refill( "on time", 0 );
+    uint32_t v = play( dac_len );
+    if ( i > 0 ) {
+      CHECK( v == tag - 1, "on time: played 0x%X, expected 0x%X",
+             v, tag - 1 );
+    }
+  }
+
+  // The interrupt runs halfway through the next target, which
+  // still leaves time to refill the idle buffer.
+  play( dac_len / 2 );
+  check_refill( "delayed ISR", 0 );
+  uint32_t late = tag;
+  play( dac_len - ( dac_len / 2 ) );
+  check_refill( "on time", 0 );
+  CHECK( play( dac_len ) == late, "delayed ISR: refill was not played" );
+
+  // The producer takes longer than a whole target, so DMA has
+  // already switched to the buffer which it is writing.
+  slow = dac_len;
+  check_refill( "slow producer", 1 );
+  slow = 0;
+  // The interrupt for that switch runs late, but is not counted
+  // as a second underrun.
+  check_refill( "after slow", 0 );
+  play( dac_len );
+
+  // The interrupt is held off past a second switch, so a whole
+  // target was missed.
+  play( dac_len );
+  check_refill( "missed target", 1 );
+  play( dac_len );
+  CHECK( play( dac_len ) == tag, "missed target: refill was not played" );
+
+  printf( "%d failure(s)\n", fails );
+  // (The firmware thread never returns)
+  exit( fails ? 1 : 0 );
+}
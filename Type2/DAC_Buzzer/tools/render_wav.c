@@ -0,0 +1,80 @@
+// Render the sequencer's song to a 16-bit mono WAV file on the
+// host machine, using the same code as the firmware, so that its
+// timing and levels can be checked without a board.
+// Build and run it with 'make render'.
+//
+// Usage: render_wav <output.wav> <sample rate> <seconds> [filter]
+// (Pass '1' as the 'filter' argument to apply the output filter)
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "seq.h"
+#include "biquad.h"
+
+extern const seq_song_t SONG;
+
+// Same output filter as the firmware, for 32kHz samples.
+static const biquad_coefs_t FILTER_COEFS[ 2 ] = {
+  {   2059,   4118,   2059,  10296,  -2148 },
+  {   2762,   5524,   2762,  13811,  -8474 }
+};
+
+#define RENDER_BLOCK ( 128 )
+
+// Write a little-endian value of 'bytes' bytes.
+static void put_le( FILE *f, uint32_t v, int bytes ) {
+  for ( int i = 0; i < bytes; ++i ) { fputc( ( v >> ( 8 * i ) ) & 0xFF, f ); }
+}
+
+int main( int argc, char **argv ) {
+  if ( argc != 4 && argc != 5 ) {
+    fprintf( stderr, "Usage: %s <output.wav> <sample rate> <seconds> [filter]\n", argv[ 0 ] );
+    return 1;
+  }
+  uint32_t rate = ( uint32_t )strtoul( argv[ 2 ], NULL, 10 );
+  uint32_t secs = ( uint32_t )strtoul( argv[ 3 ], NULL, 10 );
+  uint32_t len  = rate * secs;
+  FILE *f = fopen( argv[ 1 ], "wb" );
+  if ( !f || rate == 0 ) {
+    fprintf( stderr, "Could not open %s.\n", argv[ 1 ] );
+    return 1;
+  }
+  // RIFF / WAVE header, for 16-bit mono PCM.
+  fputs( "RIFF", f );
+  put_le( f, 36 + len * 2, 4 );
+  fputs( "WAVEfmt ", f );
+  put_le( f, 16, 4 );
+  put_le( f, 1, 2 );
+  put_le( f, 1, 2 );
+  put_le( f, rate, 4 );
+  put_le( f, rate * 2, 4 );
+  put_le( f, 2, 2 );
+  put_le( f, 16, 2 );
+  fputs( "data", f );
+  put_le( f, len * 2, 4 );
+
+  static seq_t seq;
+  biquad_t filter;
+  int use_filter = ( argc == 5 ) && ( atoi( argv[ 4 ] ) != 0 );
+  biquad_init( &filter, FILTER_COEFS, 2 );
+  uint16_t buf[ RENDER_BLOCK ];
+  uint16_t peak = 0;
+  seq_start( &seq, &SONG, rate );
+  for ( uint32_t done = 0; done < len; done += RENDER_BLOCK ) {
+    uint32_t n = ( len - done < RENDER_BLOCK ) ? ( len - done ) : RENDER_BLOCK;
+    seq_fill( &seq, buf, n );
+    if ( use_filter ) { biquad_dac( &filter, buf, n ); }
+    for ( uint32_t i = 0; i < n; ++i ) {
+      // 12-bit DAC value to signed 16-bit.
+      int32_t s = ( ( int32_t )buf[ i ] - 2048 ) * 16;
+      uint16_t mag = ( uint16_t )( ( s < 0 ) ? -s : s );
+      if ( mag > peak ) { peak = mag; }
+      put_le( f, ( uint32_t )s, 2 );
+    }
+  }
+  fclose( f );
+  printf( "%s: %u samples at %uHz, peak %u / 32768\n",
+          argv[ 1 ], len, rate, peak );
+  return 0;
+}
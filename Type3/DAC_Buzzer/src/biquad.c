@@ -0,0 +1,97 @@
+#include "biquad.h"
+#include "sections.h"
+
+// Vendor-provided device header file, for the core's intrinsics.
+#if defined( VVC_F3 )
+  #include "stm32f3xx.h"
+#elif defined( VVC_F4 )
+  #include "stm32f4xx.h"
+#elif defined( VVC_G0 )
+  #include "stm32g0xx.h"
+#endif
+
+// Cortex-M4 cores have packed 16-bit 'SIMD' multiply-accumulates.
+// (Host builds use the plain C loops)
+#if ( __CORTEX_M >= 0x04U ) && !defined( VVC_HOST )
+  #define BIQUAD_SIMD ( 1 )
+#else
+  #define BIQUAD_SIMD ( 0 )
+#endif
+
+// Set up a cascade of 'num' sections, with cleared history.
+void biquad_init( biquad_t *bq, const biquad_coefs_t *coefs, size_t num ) {
+  if ( num > BIQUAD_MAX_SECTIONS ) { num = BIQUAD_MAX_SECTIONS; }
+  bq->num = num;
+  for ( size_t i = 0; i < num; ++i ) {
+    bq->coefs[ i ] = coefs[ i ];
+    bq->x[ i ] = 0;
+    bq->y[ i ] = 0;
+  }
+}
+
+// Filter 'len' signed Q15 samples in place, through each section
+// in turn. Products are summed in 64 bits, so only the output of
+// each section is saturated.
+RAMFUNC void biquad_run( biquad_t *bq, int16_t *buf, size_t len ) {
+  for ( size_t s = 0; s < bq->num; ++s ) {
+    const biquad_coefs_t *c = &bq->coefs[ s ];
+    uint32_t x = bq->x[ s ];
+    uint32_t y = bq->y[ s ];
+#if BIQUAD_SIMD
+    // Pack the coefficients to line up with the history words,
+    // so that 'SMLALD' can apply two taps per instruction.
+    int32_t  b0 = c->b0;
+    uint32_t b  = __PKHBT( c->b1, c->b2, 16 );
+    uint32_t a  = __PKHBT( c->a1, c->a2, 16 );
+    for ( size_t i = 0; i < len; ++i ) {
+      int32_t in = buf[ i ];
+      int64_t acc = ( int64_t )( b0 * in );
+      acc = ( int64_t )__SMLALD( x, b, ( uint64_t )acc );
+      acc = ( int64_t )__SMLALD( y, a, ( uint64_t )acc );
+      int32_t out = __SSAT( ( int32_t )( acc >> BIQUAD_FRAC ), 16 );
+      // Shift the new samples into the low half-words.
+      x = __PKHBT( in, x, 16 );
+      y = __PKHBT( out, y, 16 );
+      buf[ i ] = ( int16_t )out;
+    }
+#else
+    int32_t x1 = ( int16_t )( x & 0xFFFF );
+    int32_t x2 = ( int16_t )( x >> 16 );
+    int32_t y1 = ( int16_t )( y & 0xFFFF );
+    int32_t y2 = ( int16_t )( y >> 16 );
+    for ( size_t i = 0; i < len; ++i ) {
+      int32_t in = buf[ i ];
+      int64_t acc = ( int64_t )( c->b0 * in ) +
+                    ( int64_t )( c->b1 * x1 ) +
+                    ( int64_t )( c->b2 * x2 ) +
+                    ( int64_t )( c->a1 * y1 ) +
+                    ( int64_t )( c->a2 * y2 );
+      int32_t out = ( int32_t )( acc >> BIQUAD_FRAC );
+      if ( out > 32767 ) { out = 32767; }
+      else if ( out < -32768 ) { out = -32768; }
+      x2 = x1;
+      x1 = in;
+      y2 = y1;
+      y1 = out;
+      buf[ i ] = ( int16_t )out;
+    }
+    x = ( ( uint32_t )x1 & 0xFFFF ) | ( ( uint32_t )x2 << 16 );
+    y = ( ( uint32_t )y1 & 0xFFFF ) | ( ( uint32_t )y2 << 16 );
+#endif
+    bq->x[ s ] = x;
+    bq->y[ s ] = y;
+  }
+}
+
+// Filter 'len' unsigned 12-bit DAC values in place. They are
+// converted to Q15 samples and back, in the same buffer.
+RAMFUNC void biquad_dac( biquad_t *bq, uint16_t *buf, size_t len ) {
+  int16_t *q15 = ( int16_t* )buf;
+  for ( size_t i = 0; i < len; ++i ) {
+    q15[ i ] = ( int16_t )( ( ( int32_t )buf[ i ] - 2048 ) << 4 );
+  }
+  biquad_run( bq, q15, len );
+  for ( size_t i = 0; i < len; ++i ) {
+    buf[ i ] = ( uint16_t )( 2048 + ( q15[ i ] >> 4 ) );
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef __VVC_BIQUAD_H
+#define __VVC_BIQUAD_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+
+// Most sections in one filter cascade.
+#define BIQUAD_MAX_SECTIONS ( 4 )
+// Fractional bits in the coefficients.
+#define BIQUAD_FRAC ( 14 )
+
+// Coefficients for one second-order section, in Q2.14 fixed-point
+// with the feedback terms negated. ('tools/biquad_design.py')
+// y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] + a1*y[n-1] + a2*y[n-2]
+typedef struct {
+  int16_t b0;
+  int16_t b1;
+  int16_t b2;
+  int16_t a1;
+  int16_t a2;
+} biquad_coefs_t;
+
+// Cascade of direct form I biquad sections.
+typedef struct {
+  size_t num;
+  biquad_coefs_t coefs[ BIQUAD_MAX_SECTIONS ];
+  // Past inputs and outputs of each section, as packed pairs of
+  // Q15 samples: x[n-1] / y[n-1] in the low half-words, and
+  // x[n-2] / y[n-2] in the high half-words.
+  uint32_t x[ BIQUAD_MAX_SECTIONS ];
+  uint32_t y[ BIQUAD_MAX_SECTIONS ];
+} biquad_t;
+
+void biquad_init( biquad_t *bq, const biquad_coefs_t *coefs, size_t num );
+void biquad_run( biquad_t *bq, int16_t *buf, size_t len );
+void biquad_dac( biquad_t *bq, uint16_t *buf, size_t len );
+
+#endif
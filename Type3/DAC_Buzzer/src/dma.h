@@ -0,0 +1,233 @@
+#ifndef __VVC_DMA_H
+#define __VVC_DMA_H
+
+// Macros which set up a DMA channel in the same way on each chip
+// family: F3 channels, F4 streams, and G0 channels with their
+// DMAMUX request lines. A channel is named by its controller and
+// channel numbers, so 'DMA_CH( 1, 3 )' is 'DMA1_Channel3' on F3
+// and G0 chips, or 'DMA1_Stream3' on F4 chips.
+//
+// The controller and channel numbers must be integers, or macros
+// which expand to them, and the other settings should be
+// constants. Then each macro folds down to the same register
+// writes as a hand-written sequence, even without optimizations.
+//
+// Include this after the vendor-provided device header.
+
+// DMA controller 'd'.
+#define DMA_UNIT( d )  DMA_UNIT_( d )
+#define DMA_UNIT_( d ) ( DMA##d )
+
+// Transfer directions. (In memory-to-memory mode, the
+// 'peripheral' address is the source)
+#define DMA_P2M ( 0 )
+#define DMA_M2P ( 1 )
+#define DMA_M2M ( 2 )
+// Data sizes, for the memory and peripheral sides.
+#define DMA_8BIT  ( 0 )
+#define DMA_16BIT ( 1 )
+#define DMA_32BIT ( 2 )
+
+#if defined( VVC_F4 )
+// F4 chips: 8 streams per controller, each of which picks one of
+// 8 or 16 request channels with its 'CHSEL' field.
+#define DMA_CH( d, n )   DMA_CH_( d, n )
+#define DMA_CH_( d, n )  ( DMA##d##_Stream##n )
+#define DMA_CR( d, n )   ( DMA_CH( d, n )->CR )
+#define DMA_NDTR( d, n ) ( DMA_CH( d, n )->NDTR )
+#define DMA_MAR( d, n )  ( DMA_CH( d, n )->M0AR )
+#define DMA_PAR( d, n )  ( DMA_CH( d, n )->PAR )
+// Second memory address, for double-buffer mode, and the FIFO
+// control register. (F4 streams only)
+#define DMA_M1AR( d, n ) ( DMA_CH( d, n )->M1AR )
+#define DMA_FCR( d, n )  ( DMA_CH( d, n )->FCR )
+#define DMA_EN           ( DMA_SxCR_EN )
+#define DMA_CIRC         ( DMA_SxCR_CIRC )
+#define DMA_MINC         ( DMA_SxCR_MINC )
+#define DMA_PINC         ( DMA_SxCR_PINC )
+#define DMA_HTIE         ( DMA_SxCR_HTIE )
+#define DMA_TCIE         ( DMA_SxCR_TCIE )
+// Configuration register value. 'prio' is 0 (low) to 3 (very
+// high), and 'flags' holds any of the 'DMA_x' flags above, plus
+// any other 'DMA_SxCR_x' bits such as bursts or 'DBM'.
+#define DMA_CFG( dir, msize, psize, prio, flags ) \
+  ( ( ( dir ) << DMA_SxCR_DIR_Pos ) | \
+    ( ( msize ) << DMA_SxCR_MSIZE_Pos ) | \
+    ( ( psize ) << DMA_SxCR_PSIZE_Pos ) | \
+    ( ( prio ) << DMA_SxCR_PL_Pos ) | \
+    ( flags ) )
+#define DMA_CHECK( d, n, req ) \
+  _Static_assert( ( n ) >= 0 && ( n ) <= 7, "No such DMA stream." ); \
+  _Static_assert( ( req ) >= 0 && ( req ) <= 15, "No such DMA request channel." )
+// (The request channel is part of the configuration register)
+#define DMA_ROUTE( d, n, req ) ( ( void )0 )
+#define DMA_SEL( req ) ( ( uint32_t )( req ) << DMA_SxCR_CHSEL_Pos )
+// Status flags: streams 0-3 use the 'low' registers, and 4-7 use
+// the 'high' ones, with the same uneven bit offsets.
+#define DMA_FLAG_POS( n ) ( ( ( ( n ) & 1 ) * 6 ) + ( ( ( n ) & 2 ) << 3 ) )
+#define DMA_TC_FLAG( n )  ( 0x20UL << DMA_FLAG_POS( n ) )
+#define DMA_HT_FLAG( n )  ( 0x10UL << DMA_FLAG_POS( n ) )
+#define DMA_ALL_FLAGS( n ) ( 0x3DUL << DMA_FLAG_POS( n ) )
+#define DMA_FLAGS( d, n ) \
+  ( ( ( volatile uint32_t* )&( DMA_UNIT( d )->LISR ) )[ ( n ) >> 2 ] )
+#if defined( VVC_HOST )
+// (The host simulator has no hardware behind the clear registers)
+#define DMA_CLEAR( d, n, f ) ( DMA_FLAGS( d, n ) &= ~( f ) )
+#else
+#define DMA_CLEAR( d, n, f ) \
+  ( ( ( volatile uint32_t* )&( DMA_UNIT( d )->LIFCR ) )[ ( n ) >> 2 ] = ( f ) )
+#endif
+// A stream keeps running until its current transfer ends, so
+// wait for it to actually turn off.
+#define DMA_DISABLE( d, n ) do { \
+  DMA_CR( d, n ) &= ~( DMA_SxCR_EN ); \
+  while ( DMA_CR( d, n ) & DMA_SxCR_EN ) {}; \
+} while ( 0 )
+#else
+// F3 and G0 chips: 'channels', with identical registers.
+#define DMA_CH( d, n )   DMA_CH_( d, n )
+#define DMA_CH_( d, n )  ( DMA##d##_Channel##n )
+#define DMA_CR( d, n )   ( DMA_CH( d, n )->CCR )
+#define DMA_NDTR( d, n ) ( DMA_CH( d, n )->CNDTR )
+#define DMA_MAR( d, n )  ( DMA_CH( d, n )->CMAR )
+#define DMA_PAR( d, n )  ( DMA_CH( d, n )->CPAR )
+#define DMA_EN           ( DMA_CCR_EN )
+#define DMA_CIRC         ( DMA_CCR_CIRC )
+#define DMA_MINC         ( DMA_CCR_MINC )
+#define DMA_PINC         ( DMA_CCR_PINC )
+#define DMA_HTIE         ( DMA_CCR_HTIE )
+#define DMA_TCIE         ( DMA_CCR_TCIE )
+// Configuration register value. 'prio' is 0 (low) to 3 (very
+// high), and 'flags' holds any of the 'DMA_x' flags above.
+#define DMA_CFG( dir, msize, psize, prio, flags ) \
+  ( ( ( ( dir ) == DMA_M2P ) ? DMA_CCR_DIR : 0 ) | \
+    ( ( ( dir ) == DMA_M2M ) ? DMA_CCR_MEM2MEM : 0 ) | \
+    ( ( msize ) << DMA_CCR_MSIZE_Pos ) | \
+    ( ( psize ) << DMA_CCR_PSIZE_Pos ) | \
+    ( ( prio ) << DMA_CCR_PL_Pos ) | \
+    ( flags ) )
+#if defined( VVC_G0 )
+// G0 chips route any request to any channel through the DMAMUX:
+// DMA1 channel 'n' listens to DMAMUX channel 'n - 1'.
+// Request IDs, from the 'DMAMUX' chapter of the reference manual.
+// (0 is 'no request'; 'DMAMUX_REQ_GEN' requests are not listed)
+#define DMA_REQ_ADC1          ( 5 )
+#define DMA_REQ_DAC1_CH1      ( 8 )
+#define DMA_REQ_DAC1_CH2      ( 9 )
+#define DMA_REQ_I2C1_RX       ( 10 )
+#define DMA_REQ_I2C1_TX       ( 11 )
+#define DMA_REQ_I2C2_RX       ( 12 )
+#define DMA_REQ_I2C2_TX       ( 13 )
+#define DMA_REQ_LPUART1_RX    ( 14 )
+#define DMA_REQ_LPUART1_TX    ( 15 )
+#define DMA_REQ_SPI1_RX       ( 16 )
+#define DMA_REQ_SPI1_TX       ( 17 )
+#define DMA_REQ_SPI2_RX       ( 18 )
+#define DMA_REQ_SPI2_TX       ( 19 )
+#define DMA_REQ_TIM1_CH1      ( 20 )
+#define DMA_REQ_TIM1_CH2      ( 21 )
+#define DMA_REQ_TIM1_CH3      ( 22 )
+#define DMA_REQ_TIM1_CH4      ( 23 )
+#define DMA_REQ_TIM1_TRIG_COM ( 24 )
+#define DMA_REQ_TIM1_UP       ( 25 )
+#define DMA_REQ_TIM2_CH1      ( 26 )
+#define DMA_REQ_TIM2_CH2      ( 27 )
+#define DMA_REQ_TIM2_CH3      ( 28 )
+#define DMA_REQ_TIM2_CH4      ( 29 )
+#define DMA_REQ_TIM2_TRIG     ( 30 )
+#define DMA_REQ_TIM2_UP       ( 31 )
+#define DMA_REQ_TIM3_CH1      ( 32 )
+#define DMA_REQ_TIM3_CH2      ( 33 )
+#define DMA_REQ_TIM3_CH3      ( 34 )
+#define DMA_REQ_TIM3_CH4      ( 35 )
+#define DMA_REQ_TIM3_TRIG     ( 36 )
+#define DMA_REQ_TIM3_UP       ( 37 )
+#define DMA_REQ_TIM6_UP       ( 38 )
+#define DMA_REQ_TIM7_UP       ( 39 )
+#define DMA_REQ_TIM15_CH1     ( 40 )
+#define DMA_REQ_TIM15_CH2     ( 41 )
+#define DMA_REQ_TIM15_TRIG_COM ( 42 )
+#define DMA_REQ_TIM15_UP      ( 43 )
+#define DMA_REQ_TIM16_CH1     ( 44 )
+#define DMA_REQ_TIM16_COM     ( 45 )
+#define DMA_REQ_TIM16_UP      ( 46 )
+#define DMA_REQ_TIM17_CH1     ( 47 )
+#define DMA_REQ_TIM17_COM     ( 48 )
+#define DMA_REQ_TIM17_UP      ( 49 )
+#define DMA_REQ_USART1_RX     ( 50 )
+#define DMA_REQ_USART1_TX     ( 51 )
+#define DMA_REQ_USART2_RX     ( 52 )
+#define DMA_REQ_USART2_TX     ( 53 )
+#define DMA_REQ_USART3_RX     ( 54 )
+#define DMA_REQ_USART3_TX     ( 55 )
+#define DMA_REQ_USART4_RX     ( 56 )
+#define DMA_REQ_USART4_TX     ( 57 )
+#define DMA_REQ_UCPD1_RX      ( 58 )
+#define DMA_REQ_UCPD1_TX      ( 59 )
+#define DMA_REQ_UCPD2_RX      ( 60 )
+#define DMA_REQ_UCPD2_TX      ( 61 )
+#define DMA_REQ_LAST          ( 61 )
+#define DMA_MUX( d, n ) \
+  ( ( DMAMUX_Channel_TypeDef* )( DMAMUX1_Channel0_BASE + ( 4 * ( ( n ) - 1 ) ) ) )
+#define DMA_CHECK( d, n, req ) \
+  _Static_assert( ( d ) == 1 && ( n ) >= 1 && ( n ) <= 7, "No such DMA channel." ); \
+  _Static_assert( ( req ) >= 1 && ( req ) <= DMA_REQ_LAST, "No such DMAMUX request." )
+#define DMA_ROUTE( d, n, req ) \
+  ( DMA_MUX( d, n )->CCR = ( ( req ) << DMAMUX_CxCR_DMAREQ_ID_Pos ) )
+#define DMA_SEL( req ) ( 0 )
+#else
+// F3 chips have fixed request-to-channel mappings, so 'req' must
+// be 0. (Some can be moved to another channel in 'SYSCFG_CFGR1')
+#define DMA_CHECK( d, n, req ) \
+  _Static_assert( ( d ) >= 1 && ( d ) <= 2 && ( n ) >= 1 && ( n ) <= 7, \
+                  "No such DMA channel." ); \
+  _Static_assert( ( req ) == 0, "F3 DMA requests are not routable." )
+#define DMA_ROUTE( d, n, req ) ( ( void )0 )
+#define DMA_SEL( req ) ( 0 )
+#endif
+// Status flags: 4 bits per channel, starting from channel 1.
+#define DMA_FLAG_POS( n ) ( 4 * ( ( n ) - 1 ) )
+#define DMA_TC_FLAG( n )  ( 0x2UL << DMA_FLAG_POS( n ) )
+#define DMA_HT_FLAG( n )  ( 0x4UL << DMA_FLAG_POS( n ) )
+#define DMA_ALL_FLAGS( n ) ( 0xFUL << DMA_FLAG_POS( n ) )
+#define DMA_FLAGS( d, n ) ( DMA_UNIT( d )->ISR )
+#if defined( VVC_HOST )
+// (The host simulator has no hardware behind the clear register)
+#define DMA_CLEAR( d, n, f ) ( DMA_FLAGS( d, n ) &= ~( f ) )
+#else
+#define DMA_CLEAR( d, n, f ) ( DMA_UNIT( d )->IFCR = ( f ) )
+#endif
+#define DMA_DISABLE( d, n ) ( DMA_CR( d, n ) &= ~( DMA_CCR_EN ) )
+#endif
+
+// Reserve a channel for one use, at file scope. Each claim defines
+// a one-byte constant named after the channel, so a channel which
+// is claimed twice stops the build with a 'multiple definition of
+// dma_claimed_x_y' link error, even if the claims are in different
+// files. A channel which is set up without a claim in the same file
+// stops it with an 'undeclared' error. (The constant is initialized,
+// so it is never a 'common' symbol which the linker could merge)
+#define DMA_CLAIM( d, n ) \
+  const char DMA_CLAIM_ID( d, n ) \
+    __attribute__( ( section( ".rodata.dma_claim" ), used ) ) = ( n )
+#define DMA_CLAIM_ID( d, n ) DMA_CLAIM_ID_( d, n )
+#define DMA_CLAIM_ID_( d, n ) dma_claimed_##d##_##n
+
+// Configure a disabled channel: route its request line, write its
+// configuration register ('DMA_CFG'), memory and peripheral
+// addresses, and transfer length. The settings are checked when
+// the program is compiled.
+#define DMA_INIT( d, n, req, cfg, mem, periph, len ) do { \
+  DMA_CHECK( d, n, req ); \
+  ( void )DMA_CLAIM_ID( d, n ); \
+  DMA_ROUTE( d, n, req ); \
+  DMA_CR( d, n )   = ( cfg ) | DMA_SEL( req ); \
+  DMA_MAR( d, n )  = ( uint32_t )( mem ); \
+  DMA_PAR( d, n )  = ( uint32_t )( periph ); \
+  DMA_NDTR( d, n ) = ( uint16_t )( len ); \
+} while ( 0 )
+#define DMA_ENABLE( d, n ) ( DMA_CR( d, n ) |= ( DMA_EN ) )
+// Remaining items in the current transfer.
+#define DMA_REMAINING( d, n ) ( DMA_NDTR( d, n ) )
+
+#endif
@@ -3,105 +3,505 @@
 #include <stdlib.h>
 // Vendor-provided device header file.
 #include "stm32g0xx.h"
+// Project includes.
+#include "dma.h"
+#include "reg.h"
+#include "sections.h"
+#include "dds.h"
+#include "mixer.h"
+#include "biquad.h"
+#include "adpcm.h"
+#include "rate.h"
+#include "seq.h"
+#include "bench.h"
+#include "sleep.h"
+#include "clock.h"
 
-// 32-sample sine wave.
-#define _AMP(x) ( x / 8 )
-const size_t SINE_SAMPLES = 32;
-const uint16_t SINE_WAVE[] = {
-  _AMP(2048), _AMP(2447), _AMP(2831), _AMP(3185),
-  _AMP(3495), _AMP(3750), _AMP(3939), _AMP(4056),
-  _AMP(4095), _AMP(4056), _AMP(3939), _AMP(3750),
-  _AMP(3495), _AMP(3185), _AMP(2831), _AMP(2447),
-  _AMP(2048), _AMP(1649), _AMP(1265), _AMP(911),
-  _AMP(601),  _AMP(346),  _AMP(157),  _AMP(40),
-  _AMP(0),    _AMP(40),   _AMP(157),  _AMP(346),
-  _AMP(601),  _AMP(911),  _AMP(1265), _AMP(1649)
+// Rate at which TIM6 starts triggering DAC samples, in Hertz.
+// ('audio_set_rate' can change it while audio is playing)
+#define DAC_SAMPLE_RATE ( 32000 )
+// Set to 1 to drive DAC channels 1 and 2 (PA4 / PA5) as a
+// stereo pair, or 0 for mono output on channel 1. In stereo
+// mode, both channels are loaded from one 32-bit DMA transfer
+// to the dual-channel 'DHR12RD' register on each TIM6 trigger,
+// so they stay in phase and use one DMA request per sample.
+#define AUDIO_STEREO ( 1 )
+// Sound to play:
+// 0 = two oscillators (440Hz left, 660Hz right).
+// 1 = a chord from the voice mixer.
+// 2 = a looping ADPCM clip from flash.
+// 3 = a song from the note sequencer.
+// 4 = the clip's attack, resampled to three pitches.
+#define AUDIO_DEMO ( 3 )
+#if AUDIO_STEREO
+typedef uint32_t audio_sample_t;
+#define AUDIO_DMA_SIZE ( DMA_32BIT )
+#define AUDIO_DAC_DHR  DHR12RD
+#define AUDIO_DAC_EN   ( DAC_CR_EN1 | DAC_CR_EN2 )
+#define AUDIO_DAC_TEN  ( DAC_CR_TEN1 | DAC_CR_TEN2 )
+#else
+typedef uint16_t audio_sample_t;
+#define AUDIO_DMA_SIZE ( DMA_16BIT )
+#define AUDIO_DAC_DHR  DHR12R1
+#define AUDIO_DAC_EN   ( DAC_CR_EN1 )
+#define AUDIO_DAC_TEN  ( DAC_CR_TEN1 )
+#endif
+// Streaming sample buffer. DMA reads it in circular mode, and
+// the 'half transfer' and 'transfer complete' interrupts refill
+// whichever half DMA has just finished reading.
+#define AUDIO_HALF_LEN ( 128 )
+#define AUDIO_BUF_LEN  ( AUDIO_HALF_LEN * 2 )
+audio_sample_t AUDIO_BUF[ AUDIO_BUF_LEN ] DMA_BUF;
+// DMA1 channel 1 streams it to the DAC.
+DMA_CLAIM( 1, 1 );
+// Function which writes the next 'len' samples into 'buf'.
+typedef void ( *audio_producer_t )( audio_sample_t *buf,
+                                    size_t len );
+audio_producer_t audio_producer;
+// Number of buffer halves which were not refilled in time.
+volatile uint32_t audio_underruns = 0;
+// Longest time that the producer has taken, in core clock cycles.
+volatile uint32_t audio_worst_cycles = 0;
+// Share of the last second which the core spent idle, in percent.
+volatile uint32_t cpu_idle_pct = 0;
+// Current DAC sample clock, and the timer settings for each of
+// the standard rates. ('err_ppm' shows how close each one is)
+rate_cfg_t audio_rate;
+rate_cfg_t audio_rates[ RATE_NUM_STD ];
+// Sample clock change which is waiting for a buffer boundary.
+rate_cfg_t audio_next_rate;
+#define RATE_IDLE    ( 0 )
+#define RATE_PENDING ( 1 )
+#define RATE_FILLED  ( 2 )
+volatile uint8_t audio_rate_state = RATE_IDLE;
+// Oscillators which generate the left and right samples.
+dds_t osc;
+dds_t osc_r;
+// Voices which the mixer plays together.
+#define MIX_VOICES ( 4 )
+dds_t VOICES[ MIX_VOICES ];
+// Set to 1 to time the mixer at startup with 'MIX_BENCH_VOICES'
+// voices. The result is stored in 'mix_bench_cycles', in core
+// clock cycles per output sample; it must stay below
+// ( SystemCoreClock / sample rate ) for the mixer to keep up.
+#define MIX_BENCH        ( 1 )
+#define MIX_BENCH_VOICES ( 16 )
+// ADPCM clip, generated from a WAV file by 'tools/wav2adpcm.py'.
+// (4-bit codes take a quarter of the flash of 16-bit samples)
+extern const adpcm_clip_t PLUCK;
+// Decoder which plays the clip.
+adpcm_t clip;
+// Set to 1 to pass the mono sources through a low-pass filter,
+// which softens the upper harmonics of square and saw waves.
+// (4th-order Butterworth at 5kHz, for 32kHz samples; the cutoff
+// moves in proportion if the sample rate is changed)
+#define AUDIO_FILTER ( 1 )
+const biquad_coefs_t AUDIO_FILTER_COEFS[ 2 ] = {
+  {   2059,   4118,   2059,  10296,  -2148 },
+  {   2762,   5524,   2762,  13811,  -8474 }
 };
+biquad_t audio_filter;
+// Set to 1 to time the filter at startup with 1 to 4 sections.
+// The results are stored in 'biquad_bench_cycles', in core clock
+// cycles per sample; entry [ n - 1 ] is for n sections.
+#define BIQUAD_BENCH ( 1 )
+#if BIQUAD_BENCH
+int16_t BIQUAD_BENCH_BUF[ AUDIO_HALF_LEN ];
+volatile uint32_t biquad_bench_cycles[ BIQUAD_MAX_SECTIONS ];
+#endif
+// Song in flash, and the sequencer which plays it.
+extern const seq_song_t SONG;
+seq_t seq;
+// Start of the ADPCM clip, decoded into RAM as signed samples so
+// that the resampler can read from any position.
+#define SAMPLE_LEN  ( 2048 )
+#define SAMPLE_FADE ( 256 )
+int16_t SAMPLE[ SAMPLE_LEN ] NOINIT;
+// Voices which play it at three pitches (a major triad).
+#define SAMPLE_VOICES ( 3 )
+rs_voice_t SAMPLES[ SAMPLE_VOICES ];
+// Set to 1 to time the resampler at startup in each mode. The
+// results are stored in 'rs_bench_cycles', in core clock cycles
+// per sample; the index is the 'RS_x' mode.
+#define RS_BENCH ( 1 )
+#if RS_BENCH
+int32_t RS_BENCH_ACC[ AUDIO_HALF_LEN ];
+volatile uint32_t rs_bench_cycles[ 3 ];
+// Results table names for each mode.
+const char *const RS_BENCH_NAMES[ 3 ] = {
+  "rs_nearest", "rs_linear", "rs_cubic"
+};
+#endif
+#if MIX_BENCH
+dds_t BENCH_VOICES[ MIX_BENCH_VOICES ];
+uint16_t BENCH_OUT[ AUDIO_HALF_LEN ] __attribute__( ( aligned( 4 ) ) );
+volatile uint32_t mix_bench_cycles = 0;
+#endif
 
 // Global variable to hold the core clock speed in Hertz.
 uint32_t SystemCoreClock = 16000000;
 
-// Simple imprecise delay method.
-void __attribute__( ( optimize( "O0" ) ) )
-delay_cycles( uint32_t cyc ) {
-  for ( uint32_t d_i = 0; d_i < cyc; ++d_i ) { asm( "NOP" ); }
+// Producer which plays the oscillators.
+void osc_producer( audio_sample_t *buf, size_t len ) {
+#if AUDIO_STEREO
+  dds_fill_stereo( &osc, &osc_r, buf, len );
+#else
+  dds_fill( &osc, buf, len );
+#endif
+}
+
+#if AUDIO_STEREO
+// Spread 'len' mono samples from the start of a buffer out into
+// stereo pairs, to play them on both channels. (Working from the
+// end backwards, so that no sample is overwritten before it has
+// been read)
+void audio_mono_to_stereo( audio_sample_t *buf, size_t len ) {
+  uint16_t *mono = ( uint16_t* )buf;
+  for ( size_t i = len; i > 0; --i ) {
+    uint32_t s = mono[ i - 1 ];
+    buf[ i - 1 ] = s | ( s << 16 );
+  }
+}
+#endif
+
+// Last stage for mono producers, which write 'len' samples to
+// the start of the buffer: filter them, and play them on both
+// channels in stereo mode.
+void audio_post( audio_sample_t *buf, size_t len ) {
+#if AUDIO_FILTER
+  biquad_dac( &audio_filter, ( uint16_t* )buf, len );
+#endif
+#if AUDIO_STEREO
+  audio_mono_to_stereo( buf, len );
+#endif
+}
+
+// Producer which plays the mixer's voices.
+void mix_producer( audio_sample_t *buf, size_t len ) {
+  mix_fill( VOICES, MIX_VOICES, ( uint16_t* )buf, len );
+  audio_post( buf, len );
+}
+
+// Producer which decodes the ADPCM clip straight into the
+// streaming buffer.
+void clip_producer( audio_sample_t *buf, size_t len ) {
+  adpcm_fill( &clip, ( uint16_t* )buf, len );
+  audio_post( buf, len );
+}
+
+// Producer which plays the sample voices, starting each one
+// again as soon as it ends.
+void sample_producer( audio_sample_t *buf, size_t len ) {
+  for ( size_t v = 0; v < SAMPLE_VOICES; ++v ) {
+    if ( !SAMPLES[ v ].playing ) { rs_retrigger( &SAMPLES[ v ] ); }
+  }
+  mix_fill_samples( 0, 0, SAMPLES, SAMPLE_VOICES, ( uint16_t* )buf, len );
+  audio_post( buf, len );
+}
+
+// Retune the oscillators, sequencer and sample voices for a new
+// sample rate, so that they keep playing at the same pitch and
+// tempo. (Called before 'audio_rate' changes)
+void audio_retune( uint32_t rate ) {
+  dds_set_rate( &osc, rate );
+  dds_set_rate( &osc_r, rate );
+  for ( size_t v = 0; v < MIX_VOICES; ++v ) {
+    dds_set_rate( &VOICES[ v ], rate );
+  }
+  seq_set_rate( &seq, rate );
+  for ( size_t v = 0; v < SAMPLE_VOICES; ++v ) {
+    SAMPLES[ v ].step = ( uint32_t )( ( ( uint64_t )SAMPLES[ v ].step *
+                                        audio_rate.rate ) / rate );
+  }
+}
+
+// Ask for the DAC sample rate to change to 'rate' Hertz.
+// The change happens at a buffer boundary: the next block which
+// is refilled is produced at the new rate, and TIM6 switches
+// over when DMA starts reading that block. Returns 0 if the
+// change was queued, or -1 if the rate is out of range or
+// another change is still pending.
+int audio_set_rate( uint32_t rate ) {
+  if ( audio_rate_state != RATE_IDLE ) { return -1; }
+  if ( rate_calc( clock_tim_hz(), rate, &audio_next_rate ) ) {
+    return -1;
+  }
+  audio_rate_state = RATE_PENDING;
+  return 0;
+}
+
+// Move a pending sample rate change along, before each refill.
+void audio_rate_step( void ) {
+  if ( audio_rate_state == RATE_FILLED ) {
+    // DMA has just started on the first block at the new rate.
+    // 'PSC' and 'ARR' are both preloaded, so the timer switches
+    // at its next update event without a short or long period.
+    TIM6->PSC = audio_next_rate.psc;
+    TIM6->ARR = audio_next_rate.arr;
+    audio_rate = audio_next_rate;
+    audio_rate_state = RATE_IDLE;
+  }
+  else if ( audio_rate_state == RATE_PENDING ) {
+    audio_retune( audio_next_rate.rate );
+    audio_rate_state = RATE_FILLED;
+  }
+}
+
+// Producer which plays the sequencer's song. Notes and envelopes
+// are all updated here, in the DMA interrupt, so the main loop
+// is left free.
+void seq_producer( audio_sample_t *buf, size_t len ) {
+  seq_fill( &seq, ( uint16_t* )buf, len );
+  audio_post( buf, len );
+}
+
+// Refill half of the streaming buffer, after DMA has finished
+// reading it. Also record the producer's timing, and whether
+// DMA had already wrapped back around to this half.
+RAMFUNC void audio_refill( size_t half ) {
+  audio_rate_step();
+  uint32_t start = bench_start();
+  audio_producer( &AUDIO_BUF[ half * AUDIO_HALF_LEN ], AUDIO_HALF_LEN );
+  uint32_t cycles = bench_stop( "producer", start );
+  if ( cycles > audio_worst_cycles ) { audio_worst_cycles = cycles; }
+  size_t pos = AUDIO_BUF_LEN - DMA_REMAINING( 1, 1 );
+  if ( ( pos / AUDIO_HALF_LEN ) == half ) { ++audio_underruns; }
+}
+
+#if MIX_BENCH
+// Mix one buffer half with 'MIX_BENCH_VOICES' voices, and
+// return the number of cycles taken per output sample.
+uint32_t mix_bench( uint32_t rate ) {
+  for ( size_t v = 0; v < MIX_BENCH_VOICES; ++v ) {
+    dds_init( &BENCH_VOICES[ v ], rate );
+    dds_set_freq( &BENCH_VOICES[ v ], DDS_HZ( 110 ) * ( v + 1 ) );
+    BENCH_VOICES[ v ].amp = 16;
+  }
+  uint32_t start = bench_start();
+  mix_fill( BENCH_VOICES, MIX_BENCH_VOICES, BENCH_OUT, AUDIO_HALF_LEN );
+  uint32_t cycles = bench_stop( "mix_bench", start );
+  return ( cycles / AUDIO_HALF_LEN );
+}
+#endif
+
+#if RS_BENCH
+// Play one buffer half of the sine wavetable at 1.5x speed in
+// interpolation mode 'mode', and return the number of cycles
+// taken per sample.
+uint32_t rs_bench( uint8_t mode ) {
+  rs_voice_t v;
+  rs_start( &v, WAVE_SINE, WAVE_TABLE_LEN, 1 );
+  v.mode = mode;
+  v.step = RS_PITCH( 1.5 );
+  for ( size_t i = 0; i < AUDIO_HALF_LEN; ++i ) { RS_BENCH_ACC[ i ] = 0; }
+  uint32_t start = bench_start();
+  rs_add( &v, RS_BENCH_ACC, AUDIO_HALF_LEN );
+  uint32_t cycles = bench_stop( RS_BENCH_NAMES[ mode ], start );
+  return ( cycles / AUDIO_HALF_LEN );
+}
+#endif
+
+#if BIQUAD_BENCH
+// Filter one buffer half of a sawtooth wave with 'num' copies of
+// the output filter's first section, and return the number of
+// cycles taken per sample.
+uint32_t biquad_bench( size_t num ) {
+  biquad_coefs_t coefs[ BIQUAD_MAX_SECTIONS ];
+  biquad_t bq;
+  for ( size_t s = 0; s < num; ++s ) { coefs[ s ] = AUDIO_FILTER_COEFS[ 0 ]; }
+  biquad_init( &bq, coefs, num );
+  for ( size_t i = 0; i < AUDIO_HALF_LEN; ++i ) {
+    BIQUAD_BENCH_BUF[ i ] = ( int16_t )( ( i & 0x3F ) * 512 - 16384 );
+  }
+  uint32_t start = bench_start();
+  biquad_run( &bq, BIQUAD_BENCH_BUF, AUDIO_HALF_LEN );
+  uint32_t cycles = bench_stop( "biquad_bench", start );
+  return ( cycles / AUDIO_HALF_LEN );
+}
+#endif
+
+// Record the core's idle time once per second.
+void idle_report( void ) {
+  cpu_idle_pct = sleep_idle_percent();
+  sleep_after( 1000, idle_report );
 }
 
 /**
  * Main program.
  */
 int main(void) {
+  // Run the core at its highest rated speed.
+  clock_init( CLOCK_MAX_HZ );
+
   // Enable peripherals: GPIOA, DMA, DAC, TIM6.
   RCC->IOPENR   |= RCC_IOPENR_GPIOAEN;
   RCC->AHBENR   |= RCC_AHBENR_DMA1EN;
   RCC->APBENR1  |= ( RCC_APBENR1_DAC1EN |
                      RCC_APBENR1_TIM6EN );
 
-  // Pin A4 output type: Analog.
-  GPIOA->MODER    &= ~( 0x3 << ( 4 * 2 ) );
-  GPIOA->MODER    |=  ( 0x3 << ( 4 * 2 ) );
+  // Pins A4/A5 output type: Analog.
+  REG_SET( GPIOA->MODER, ( 0x3 << ( 4 * 2 ) |
+                           0x3 << ( 5 * 2 ) ),
+                         ( 0x3 << ( 4 * 2 ) |
+                           0x3 << ( 5 * 2 ) ) );
+
+  // Start the cycle counter, to time the producer, and the
+  // millisecond timer.
+  bench_init();
+  sleep_init();
+
+  // Work out the timer settings for the standard sample rates,
+  // and for the rate which playback starts at.
+  for ( size_t i = 0; i < RATE_NUM_STD; ++i ) {
+    rate_calc( clock_tim_hz(), RATE_STD[ i ], &audio_rates[ i ] );
+  }
+  rate_calc( clock_tim_hz(), DAC_SAMPLE_RATE, &audio_rate );
+
+  // Set up the oscillator for the exact sample rate which
+  // TIM6 can produce, and fill the streaming buffer.
+  dds_init( &osc, audio_rate.rate );
+  dds_set_freq( &osc, DDS_HZ( 440 ) );
+  dds_init( &osc_r, audio_rate.rate );
+  dds_set_freq( &osc_r, DDS_HZ( 660 ) );
+  // Mixer voices: an A major chord, with band-limited
+  // sawtooth waves.
+  const uint32_t chord[ MIX_VOICES ] = {
+    DDS_HZ( 440 ), DDS_HZ( 554.37 ), DDS_HZ( 659.26 ), DDS_HZ( 880 )
+  };
+  for ( size_t v = 0; v < MIX_VOICES; ++v ) {
+    dds_init( &VOICES[ v ], audio_rate.rate );
+    dds_set_freq( &VOICES[ v ], chord[ v ] );
+    VOICES[ v ].table = WAVE_SAW_BL;
+  }
+#if MIX_BENCH
+  // Time the mixer before the DMA interrupt starts using the CPU.
+  mix_bench_cycles = mix_bench( audio_rate.rate );
+#endif
+#if BIQUAD_BENCH
+  for ( size_t s = 1; s <= BIQUAD_MAX_SECTIONS; ++s ) {
+    biquad_bench_cycles[ s - 1 ] = biquad_bench( s );
+  }
+#endif
+#if RS_BENCH
+  for ( uint8_t m = RS_NEAREST; m <= RS_CUBIC; ++m ) {
+    rs_bench_cycles[ m ] = rs_bench( m );
+  }
+#endif
+  biquad_init( &audio_filter, AUDIO_FILTER_COEFS, 2 );
+  // Loop the clip. (It was encoded at 'DAC_SAMPLE_RATE')
+  adpcm_start( &clip, &PLUCK, 1 );
+  seq_start( &seq, &SONG, audio_rate.rate );
+  // Decode the start of the clip for the sample voices, and fade
+  // out its last few samples so that it does not end with a click.
+  adpcm_t dec;
+  adpcm_start( &dec, &PLUCK, 0 );
+  adpcm_fill( &dec, ( uint16_t* )SAMPLE, SAMPLE_LEN );
+  for ( size_t i = 0; i < SAMPLE_LEN; ++i ) {
+    int32_t s = ( int32_t )( ( uint16_t )SAMPLE[ i ] ) - 2048;
+    if ( i >= ( SAMPLE_LEN - SAMPLE_FADE ) ) {
+      s = ( s * ( int32_t )( SAMPLE_LEN - i ) ) / SAMPLE_FADE;
+    }
+    SAMPLE[ i ] = ( int16_t )s;
+  }
+  const uint32_t pitches[ SAMPLE_VOICES ] = {
+    RS_PITCH( 1.0 ), RS_PITCH( 1.2599 ), RS_PITCH( 1.4983 )
+  };
+  for ( size_t v = 0; v < SAMPLE_VOICES; ++v ) {
+    rs_start( &SAMPLES[ v ], SAMPLE, SAMPLE_LEN, 0 );
+    SAMPLES[ v ].step = pitches[ v ];
+    SAMPLES[ v ].mode = RS_CUBIC;
+    SAMPLES[ v ].amp  = 80;
+  }
+#if AUDIO_DEMO == 0
+  audio_producer = osc_producer;
+#elif AUDIO_DEMO == 1
+  audio_producer = mix_producer;
+#elif AUDIO_DEMO == 2
+  audio_producer = clip_producer;
+#elif AUDIO_DEMO == 3
+  audio_producer = seq_producer;
+#else
+  audio_producer = sample_producer;
+#endif
+  audio_producer( AUDIO_BUF, AUDIO_BUF_LEN );
 
   // DMA configuration (channel 1).
-  // CCR register:
+  // - DAC Ch1 requests, through DMAMUX channel 0.
   // - Memory-to-peripheral
   // - Circular mode enabled.
+  // - 'Half transfer' and 'transfer complete' interrupts enabled.
   // - Increment memory ptr, don't increment periph ptr.
-  // - 16-bit data size for both source and destination.
+  // - 16-bit (mono) or 32-bit (stereo) data size for both
+  //   source and destination.
   // - High priority.
-  uint32_t dma_ccr_clr = ~( DMA_CCR_MEM2MEM |
-                            DMA_CCR_PL |
-                            DMA_CCR_MSIZE |
-                            DMA_CCR_PSIZE |
-                            DMA_CCR_PINC |
-                            DMA_CCR_EN );
-  uint32_t dma_ccr_set =  ( ( 0x2 << DMA_CCR_PL_Pos ) |
-                            ( 0x1 << DMA_CCR_MSIZE_Pos ) |
-                            ( 0x1 << DMA_CCR_PSIZE_Pos ) |
-                            DMA_CCR_MINC |
-                            DMA_CCR_CIRC |
-                            DMA_CCR_DIR );
-  DMA1_Channel1->CCR &= dma_ccr_clr;
-  DMA1_Channel1->CCR |= dma_ccr_set;
-  // Select DAC Ch1 as DMA Ch1 request source in DMAMUX.
-  // Note: DMAMUX channel numbers are slightly confusing in
-  // the documentation. They aren't reliably 0- or 1-indexed.
-  DMAMUX1_Channel0->CCR &= ~( DMAMUX_CxCR_DMAREQ_ID );
-  DMAMUX1_Channel0->CCR |=  ( 0x8 << DMAMUX_CxCR_DMAREQ_ID_Pos );
-  // Set DMA source and destination addresses.
-  // Source: Address of the sine wave buffer in memory.
-  DMA1_Channel1->CMAR  = ( uint32_t )&SINE_WAVE;
-  // Dest.: DAC1 Ch1 '12-bit right-aligned data' register.
-  DMA1_Channel1->CPAR  = ( uint32_t )&( DAC1->DHR12R1 );
-  // Set DMA data transfer length (# of sine wave samples).
-  DMA1_Channel1->CNDTR = ( uint16_t )SINE_SAMPLES;
+  // Source: Address of the streaming buffer in memory.
+  // Dest.: DAC1 Ch1 '12-bit right-aligned data' register,
+  // or the 'dual 12-bit right-aligned data' register in stereo.
+  // Length: # of streaming buffer samples.
+  DMA_INIT( 1, 1, DMA_REQ_DAC1_CH1,
+            DMA_CFG( DMA_M2P, AUDIO_DMA_SIZE, AUDIO_DMA_SIZE, 2,
+                     DMA_MINC | DMA_CIRC | DMA_HTIE | DMA_TCIE ),
+            &AUDIO_BUF, &( DAC1->AUDIO_DAC_DHR ), AUDIO_BUF_LEN );
+  // Enable the DMA interrupt, which refills the buffer.
+  NVIC_SetPriority( DMA1_Channel1_IRQn, 0x03 );
+  NVIC_EnableIRQ( DMA1_Channel1_IRQn );
   // Enable DMA1 Channels 1/2.
-  DMA1_Channel1->CCR |= ( DMA_CCR_EN );
+  DMA_ENABLE( 1, 1 );
 
   // TIM6 configuration.
-  // Set prescaler and autoreload for a 440Hz sine wave.
-  TIM6->PSC  =  ( 0x0000 );
-  TIM6->ARR  =  ( SystemCoreClock / ( 440 * SINE_SAMPLES ) );
+  // Set prescaler and autoreload for the DAC sample rate.
+  // Auto-reload preload lets the rate change while the timer
+  // is running; an update event loads both registers now.
+  TIM6->PSC  =  ( audio_rate.psc );
+  TIM6->ARR  =  ( audio_rate.arr );
+  TIM6->CR1 |=  ( TIM_CR1_ARPE );
+  TIM6->EGR  =  ( TIM_EGR_UG );
   // Enable trigger output on timer update events.
-  TIM6->CR2 &= ~( TIM_CR2_MMS );
-  TIM6->CR2 |=  ( 0x2 << TIM_CR2_MMS_Pos );
+  REG_SET( TIM6->CR2, ( TIM_CR2_MMS ),
+                      ( 0x2 << TIM_CR2_MMS_Pos ) );
   // Start the timer.
   TIM6->CR1 |=  ( TIM_CR1_CEN );
 
   // DAC configuration.
-  // Set trigger source to TIM6 TRGO.
-  DAC1->CR  &= ~( DAC_CR_TSEL1 );
-  DAC1->CR  |=  ( 0x5 << DAC_CR_TSEL1_Pos );
+  // Set trigger sources to TIM6 TRGO.
+  REG_SET( DAC1->CR, ( DAC_CR_TSEL1 |
+                       DAC_CR_TSEL2 ),
+                     ( 0x5 << DAC_CR_TSEL1_Pos |
+                       0x5 << DAC_CR_TSEL2_Pos ) );
   // Set outputs to buffered GPIO 'normal mode'.
-  DAC1->MCR &= ~( DAC_MCR_MODE1 );
-  // Enable DAC DMA requests.
+  DAC1->MCR &= ~( DAC_MCR_MODE1 |
+                  DAC_MCR_MODE2 );
+  // Enable DAC DMA requests. (Channel 1 only; in stereo mode,
+  // each request moves a sample for both channels)
   DAC1->CR  |=  ( DAC_CR_DMAEN1 );
   // Enable DAC Channels.
-  DAC1->CR  |=  ( DAC_CR_EN1 );
-  // Delay briefly to allow sampling to stabilize (?)
-  delay_cycles( 1000 );
+  DAC1->CR  |=  ( AUDIO_DAC_EN );
+  // Wait for the DAC's output to settle. (Its startup time is
+  // a few microseconds)
+  sleep_us( 10 );
   // Enable DAC channel trigger.
-  DAC1->CR  |=  ( DAC_CR_TEN1 );
+  DAC1->CR  |=  ( AUDIO_DAC_TEN );
+
+  // Done; the 'AUDIO_DEMO' sound should be playing on PA4, and
+  // also on PA5 in stereo mode.
+  // The DMA interrupt keeps the streaming buffer filled, and
+  // 'audio_underruns' / 'audio_worst_cycles' can be read with
+  // a debugger to check that the producer keeps up, along with
+  // 'cpu_idle_pct' to see how much time is left over.
+  sleep_after( 1000, idle_report );
+  while (1) {
+    sleep_idle();
+  }
+}
 
-  // Done; a low-res 440Hz sine wave should be playing on PA4.
-  while (1) {}
+// DMA1 channel 1 interrupt handler.
+RAMFUNC void DMA1_chan1_IRQ_handler( void ) {
+  if ( DMA_FLAGS( 1, 1 ) & DMA_HT_FLAG( 1 ) ) {
+    DMA_CLEAR( 1, 1, DMA_HT_FLAG( 1 ) );
+    audio_refill( 0 );
+  }
+  if ( DMA_FLAGS( 1, 1 ) & DMA_TC_FLAG( 1 ) ) {
+    DMA_CLEAR( 1, 1, DMA_TC_FLAG( 1 ) );
+    audio_refill( 1 );
+  }
 }
@@ -0,0 +1,33 @@
+#ifndef __VVC_RATE_H
+#define __VVC_RATE_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+
+// Standard audio sample rates, in Hertz.
+#define RATE_8K    ( 8000 )
+#define RATE_16K   ( 16000 )
+#define RATE_22K05 ( 22050 )
+#define RATE_44K1  ( 44100 )
+#define RATE_48K   ( 48000 )
+#define RATE_NUM_STD ( 5 )
+extern const uint32_t RATE_STD[ RATE_NUM_STD ];
+
+// Timer settings for one sample rate.
+typedef struct {
+  // Rate which was asked for, in Hertz.
+  uint32_t want;
+  // Prescaler and auto-reload register values.
+  uint16_t psc;
+  uint16_t arr;
+  // Rate which the timer will actually produce, rounded to the
+  // nearest Hertz.
+  uint32_t rate;
+  // Error of the actual rate, in parts per million.
+  int32_t  err_ppm;
+} rate_cfg_t;
+
+int rate_calc( uint32_t clk, uint32_t want, rate_cfg_t *cfg );
+
+#endif
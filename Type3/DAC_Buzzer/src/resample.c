@@ -0,0 +1,92 @@
+#include "resample.h"
+#include "sections.h"
+
+// Start playing a sample from the beginning, at its own pitch,
+// with linear interpolation and a quiet volume.
+void rs_start( rs_voice_t *v, const int16_t *data, uint32_t len, uint8_t loop ) {
+  v->data    = data;
+  v->len     = len;
+  v->pos     = 0;
+  v->frac    = 0;
+  v->step    = RS_PITCH( 1 );
+  v->amp     = 32;
+  v->mode    = RS_LINEAR;
+  v->loop    = loop;
+  v->playing = 1;
+}
+
+// Play a voice again from the beginning, keeping its settings.
+void rs_retrigger( rs_voice_t *v ) {
+  v->pos     = 0;
+  v->frac    = 0;
+  v->playing = 1;
+}
+
+// Read a sample at any index, wrapping around for looping samples
+// and repeating the first or last sample otherwise.
+static inline RAMFUNC int32_t rs_at( const rs_voice_t *v, int32_t i ) {
+  int32_t len = ( int32_t )v->len;
+  if ( i < 0 ) { i = v->loop ? ( i + len ) : 0; }
+  else if ( i >= len ) { i = v->loop ? ( i - len ) : ( len - 1 ); }
+  return v->data[ i ];
+}
+
+// Interpolate between samples 'i' and 'i + 1', at 'frac' / 65536.
+static inline RAMFUNC int32_t rs_linear( const rs_voice_t *v, int32_t i, int32_t frac ) {
+  int32_t s0 = rs_at( v, i );
+  int32_t s1 = rs_at( v, i + 1 );
+  return s0 + ( ( ( s1 - s0 ) * frac ) >> 16 );
+}
+
+// 4-point cubic (Catmull-Rom) interpolation between samples 'i'
+// and 'i + 1', using the samples on either side as well. The
+// polynomial's coefficients are doubled to keep them integers.
+static inline RAMFUNC int32_t rs_cubic( const rs_voice_t *v, int32_t i, int32_t frac ) {
+  int32_t sm = rs_at( v, i - 1 );
+  int32_t s0 = rs_at( v, i );
+  int32_t s1 = rs_at( v, i + 1 );
+  int32_t s2 = rs_at( v, i + 2 );
+  int32_t t  = frac >> 1;
+  int32_t a  = -sm + ( 3 * s0 ) - ( 3 * s1 ) + s2;
+  int32_t b  = ( 2 * sm ) - ( 5 * s0 ) + ( 4 * s1 ) - s2;
+  int32_t c  = s1 - sm;
+  int32_t y  = ( ( a * t ) >> 15 ) + b;
+  y = ( ( y * t ) >> 15 ) + c;
+  y = ( ( y * t ) >> 15 ) + ( 2 * s0 );
+  return ( y >> 1 );
+}
+
+// Add the next 'len' output samples of a voice to a mixer's
+// accumulators, in units of 1/32768 of a DAC count.
+RAMFUNC void rs_add( rs_voice_t *v, int32_t *acc, size_t len ) {
+  if ( !v->playing ) { return; }
+  int32_t vol = ( v->amp >= 256 ) ? 0x7FFF : ( ( int32_t )v->amp << 7 );
+  uint32_t pos  = v->pos;
+  uint32_t frac = v->frac;
+  for ( size_t i = 0; i < len; ++i ) {
+    int32_t s;
+    if ( v->mode == RS_CUBIC ) {
+      s = rs_cubic( v, ( int32_t )pos, ( int32_t )frac );
+    }
+    else if ( v->mode == RS_LINEAR ) {
+      s = rs_linear( v, ( int32_t )pos, ( int32_t )frac );
+    }
+    else {
+      s = v->data[ pos ];
+    }
+    acc[ i ] += s * vol;
+    frac += v->step;
+    pos  += ( frac >> 16 );
+    frac &= 0xFFFF;
+    if ( pos >= v->len ) {
+      if ( !v->loop ) {
+        v->playing = 0;
+        break;
+      }
+      // (Steps can skip more than one whole sample)
+      while ( pos >= v->len ) { pos -= v->len; }
+    }
+  }
+  v->pos  = pos;
+  v->frac = frac;
+}
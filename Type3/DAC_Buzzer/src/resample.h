@@ -0,0 +1,44 @@
+#ifndef __VVC_RESAMPLE_H
+#define __VVC_RESAMPLE_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+
+// Interpolation modes.
+#define RS_NEAREST ( 0 )
+#define RS_LINEAR  ( 1 )
+#define RS_CUBIC   ( 2 )
+
+// Convert a constant playback speed to a 16.16 fixed-point step.
+// ( 1.0 plays the sample at the rate it was recorded at, if that
+// matches the DAC rate; 2.0 plays it an octave higher )
+#define RS_PITCH( x ) ( ( uint32_t )( ( x ) * 65536.0 ) )
+
+// Voice which plays a recorded sample at any pitch.
+typedef struct {
+  // Signed 12-bit samples, and how many there are (at least 4).
+  const int16_t *data;
+  uint32_t len;
+  // Read position, split into a whole sample index and a 16-bit
+  // fraction between that sample and the next one.
+  uint32_t pos;
+  uint32_t frac;
+  // Position increment per output sample, in 16.16 fixed-point.
+  uint32_t step;
+  // Output volume, out of 256.
+  uint16_t amp;
+  // Interpolation mode: 'RS_NEAREST', 'RS_LINEAR' or 'RS_CUBIC'.
+  uint8_t  mode;
+  // Start again from the beginning after the last sample if
+  // nonzero; otherwise, stop.
+  uint8_t  loop;
+  // Nonzero until a sample which does not loop has ended.
+  uint8_t  playing;
+} rs_voice_t;
+
+void rs_start( rs_voice_t *v, const int16_t *data, uint32_t len, uint8_t loop );
+void rs_retrigger( rs_voice_t *v );
+void rs_add( rs_voice_t *v, int32_t *acc, size_t len );
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef __VVC_SEQ_H
+#define __VVC_SEQ_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+// Project includes.
+#include "dds.h"
+
+// Most tracks (simultaneous notes) in one song.
+#define SEQ_MAX_TRACKS ( 4 )
+// Envelopes are updated once every 'SEQ_CTRL_LEN' samples, and
+// events start on those boundaries.
+#define SEQ_CTRL_LEN   ( 16 )
+// Special 'note' values: silence, and the end of a track.
+#define SEQ_REST       ( 0xFE )
+#define SEQ_END        ( 0xFF )
+
+// One note or rest in a track. Tracks are arrays of these,
+// ending with a 'SEQ_END' event.
+typedef struct {
+  // MIDI note number (60 = middle C), or 'SEQ_REST' / 'SEQ_END'.
+  uint8_t  note;
+  // Index of the envelope to play the note with.
+  uint8_t  env;
+  // Length of the note, in ticks.
+  uint16_t ticks;
+} seq_event_t;
+
+// Attack / decay / sustain / release envelope.
+typedef struct {
+  // Time to rise to full volume, and then to fall to the
+  // sustain level, in milliseconds.
+  uint16_t attack_ms;
+  uint16_t decay_ms;
+  // Time to fall to silence after the note is released.
+  uint16_t release_ms;
+  // Volume while the note is held, out of 255.
+  uint8_t  sustain;
+  // Part of each note's length before it is released, out
+  // of 256. (256 holds notes until the next one starts)
+  uint16_t gate;
+} seq_env_t;
+
+// One monophonic part of a song.
+typedef struct {
+  const seq_event_t *events;
+  // Wavetable to play the notes with. ('WAVE_SINE' etc.)
+  const int16_t *table;
+  // Track volume, out of 256.
+  uint16_t amp;
+} seq_track_t;
+
+// Song, stored in flash.
+typedef struct {
+  const seq_track_t *tracks;
+  uint8_t  num_tracks;
+  const seq_env_t *envs;
+  // Tempo, in beats per minute and ticks per beat.
+  uint16_t bpm;
+  uint8_t  tpb;
+  // Start again after every track has ended if nonzero.
+  uint8_t  loop;
+} seq_song_t;
+
+// Envelope states.
+#define SEQ_ENV_OFF     ( 0 )
+#define SEQ_ENV_ATTACK  ( 1 )
+#define SEQ_ENV_DECAY   ( 2 )
+#define SEQ_ENV_SUSTAIN ( 3 )
+#define SEQ_ENV_RELEASE ( 4 )
+
+// Playback state for one track.
+typedef struct {
+  // Index of the current event.
+  uint16_t ev;
+  // Samples until the next event, and until the current note
+  // is released.
+  int32_t  left;
+  int32_t  gate_left;
+  // Envelope state and level. ( 1 << 24 ) is full volume.
+  uint8_t  env_state;
+  uint8_t  done;
+  const seq_env_t *env;
+  int32_t  level;
+  // Envelope level change per sample, in the current state.
+  int32_t  inc;
+} seq_track_state_t;
+
+// Sequencer state.
+typedef struct {
+  const seq_song_t *song;
+  // Output sample rate, and samples per tick.
+  uint32_t rate;
+  uint32_t tick_len;
+  // Nonzero while the song is playing.
+  uint8_t  playing;
+  seq_track_state_t tracks[ SEQ_MAX_TRACKS ];
+  // One oscillator per track, mixed together.
+  dds_t voices[ SEQ_MAX_TRACKS ];
+} seq_t;
+
+void seq_start( seq_t *seq, const seq_song_t *song, uint32_t rate );
+void seq_set_rate( seq_t *seq, uint32_t rate );
+void seq_fill( seq_t *seq, uint16_t *buf, size_t len );
+
+#endif
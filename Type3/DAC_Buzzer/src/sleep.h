@@ -0,0 +1,28 @@
+#ifndef __VVC_SLEEP_H
+#define __VVC_SLEEP_H
+
+// Standard library includes.
+#include <stdint.h>
+#include <stdlib.h>
+
+// Most timeouts which can be waiting at once.
+#define SLEEP_MAX_TIMEOUTS ( 4 )
+
+// Function which runs when a timeout expires. Callbacks run in
+// the timer's interrupt handler, so they should be short.
+typedef void ( *sleep_cb_t )( void );
+
+// Total time which the core has spent idle, in microseconds.
+extern volatile uint32_t sleep_idle_us;
+
+void     sleep_init( void );
+uint32_t sleep_millis( void );
+uint32_t sleep_micros( void );
+void     sleep_idle( void );
+void     sleep_us( uint32_t us );
+void     sleep_ms( uint32_t ms );
+int      sleep_after( uint32_t ms, sleep_cb_t cb );
+void     sleep_cancel( int id );
+uint32_t sleep_idle_percent( void );
+
+#endif
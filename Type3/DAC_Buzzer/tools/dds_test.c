@@ -0,0 +1,114 @@
+// Check the DDS oscillator's tuning on the host machine.
+// Build and run it with 'make dds-test'.
+//
+// For each sample rate, 'rate_calc' picks the timer settings from
+// the given timer clock, and the oscillator is tuned with the
+// rounded rate which it reports, just like the firmware does. The
+// pitch error is then measured against the rate which the timer
+// really produces ( clk / ( ( PSC + 1 ) * ( ARR + 1 ) ) ), by
+// counting zero crossings in the oscillator's output.
+// Returns non-zero if any tuning word or pitch is out of bounds.
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dds.h"
+#include "rate.h"
+
+// Seconds of output to measure for each pitch.
+#define TEST_SECS ( 10 )
+#define BLOCK_LEN ( 256 )
+
+// Target pitches, in Hertz: A0, A2, middle C, A4, and a few
+// fractional and out-of-tune values.
+static const double PITCHES[ 8 ] = {
+  27.5, 110.0, 261.6256, 440.0, 440.5, 1000.25, 3520.0, 3.3
+};
+
+// Measure an oscillator's output frequency in cycles per sample,
+// from the first and last rising zero crossings. The crossing
+// times are interpolated between samples. Also returns the number
+// of whole cycles which were measured.
+static double measure( dds_t *dds, size_t len, uint32_t *cycles ) {
+  uint16_t buf[ BLOCK_LEN ];
+  double first = -1.0, last = -1.0;
+  uint32_t n = 0;
+  int32_t prev = 0;
+  for ( size_t done = 0; done < len; done += BLOCK_LEN ) {
+    dds_fill( dds, buf, BLOCK_LEN );
+    for ( size_t i = 0; i < BLOCK_LEN; ++i ) {
+      int32_t cur = ( int32_t )buf[ i ] - 2048;
+      if ( ( done + i ) > 0 && prev < 0 && cur >= 0 ) {
+        double t = ( double )( done + i - 1 ) +
+                   ( double )( -prev ) / ( double )( cur - prev );
+        if ( first < 0 ) { first = t; }
+        else { ++n; }
+        last = t;
+      }
+      prev = cur;
+    }
+  }
+  *cycles = n;
+  return ( n > 0 ) ? ( n / ( last - first ) ) : 0.0;
+}
+
+int main( int argc, char **argv ) {
+  uint32_t clk  = ( argc > 1 ) ? strtoul( argv[ 1 ], 0, 10 ) : 64000000;
+  uint32_t conf = ( argc > 2 ) ? strtoul( argv[ 2 ], 0, 10 ) : 32000;
+  uint32_t rates[ RATE_NUM_STD + 1 ];
+  rates[ 0 ] = conf;
+  for ( int i = 0; i < RATE_NUM_STD; ++i ) { rates[ i + 1 ] = RATE_STD[ i ]; }
+
+  int fails = 0;
+  printf( "timer clock %uHz, configured rate %uHz\n", clk, conf );
+  printf( "%8s %5s %5s %8s %14s %10s %12s %10s %10s\n",
+          "want", "psc", "arr", "rate", "achieved", "pitch",
+          "step", "err mHz", "err cents" );
+  for ( int r = 0; r <= RATE_NUM_STD; ++r ) {
+    rate_cfg_t cfg;
+    if ( rate_calc( clk, rates[ r ], &cfg ) ) {
+      printf( "%8u: rate_calc failed\n", rates[ r ] );
+      ++fails;
+      continue;
+    }
+    // Rate which the timer really triggers the DAC at.
+    double achieved = ( double )clk /
+                      ( ( cfg.psc + 1.0 ) * ( cfg.arr + 1.0 ) );
+    for ( int p = 0; p < 8; ++p ) {
+      uint32_t hz_q16 = DDS_HZ( PITCHES[ p ] );
+      double want = hz_q16 / 65536.0;
+      dds_t dds;
+      dds_init( &dds, cfg.rate );
+      dds.amp = 256;
+      dds_set_freq( &dds, hz_q16 );
+      // The tuning word must be the nearest one for the rate which
+      // 'rate_calc' reported.
+      double ideal = want / cfg.rate * 4294967296.0;
+      if ( fabs( dds.step - ideal ) > 0.5 ) {
+        printf( "%8u %8.4fHz: step %u, expected %.2f\n",
+                rates[ r ], want, dds.step, ideal );
+        ++fails;
+      }
+      // Measured output frequency, at the timer's achieved rate.
+      uint32_t cycles;
+      double out = measure( &dds, TEST_SECS * cfg.rate, &cycles ) *
+                   achieved;
+      double err = out - want;
+      // Allowed error: the achieved rate is rounded to 0.5Hz in
+      // 'cfg.rate', the step to 0.5 counts, and each measured
+      // crossing can be off by one wavetable entry.
+      double bound = want * ( 0.5 / cfg.rate ) +
+                     achieved / 8589934592.0 +
+                     want * 2.0 / ( ( double )DDS_TABLE_LEN * cycles );
+      int ok = ( cycles > 0 ) && ( fabs( err ) <= bound );
+      printf( "%8u %5u %5u %8u %14.4f %10.4f %12u %10.4f %10.5f%s\n",
+              rates[ r ], cfg.psc, cfg.arr, cfg.rate, achieved, want,
+              dds.step, err * 1000.0, 1200.0 * log2( out / want ),
+              ok ? "" : "  FAIL" );
+      if ( !ok ) { ++fails; }
+    }
+  }
+  printf( "%d failure(s)\n", fails );
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+# Synthesize the 'pluck' demo clip as a 16-bit mono PCM WAV file.
+#
+# Usage: gen_pluck.py <output.wav>
+#
+# The clip is 4096 samples at 32kHz: a 220Hz tone with its second
+# and third harmonics, decaying exponentially. 'make pluck' runs
+# this and 'tools/wav2adpcm.py' to regenerate 'src/pluck.c'.
+import math
+import struct
+import sys
+import wave
+
+RATE = 32000
+LEN  = 4096
+# ( frequency in Hertz, level ) of each partial.
+PARTIALS = [ ( 220, 0.6 ), ( 440, 0.25 ), ( 660, 0.15 ) ]
+# Decay rate, per second.
+DECAY = 30
+PEAK  = 30000
+
+def main():
+  if len( sys.argv ) != 2:
+    sys.exit( 'Usage: %s <output.wav>' % sys.argv[ 0 ] )
+  frames = b''
+  for i in range( LEN ):
+    t = i / RATE
+    v = math.exp( -t * DECAY ) * sum( level * math.sin( 2 * math.pi * f * t )
+                                      for f, level in PARTIALS )
+    frames += struct.pack( '<h', int( v * PEAK ) )
+  with wave.open( sys.argv[ 1 ], 'wb' ) as w:
+    w.setnchannels( 1 )
+    w.setsampwidth( 2 )
+    w.setframerate( RATE )
+    w.writeframes( frames )
+
+if __name__ == '__main__':
+  main()
@@ -3,12 +3,80 @@
 #include <stdlib.h>
 // Vendor-provided device header file.
 #include "stm32g0xx.h"
+// Project includes.
+#include "dma.h"
+#include "reg.h"
+#include "sections.h"
+#include "bench.h"
+#include "sleep.h"
+#include "clock.h"
 
 // 128x64-pixel monochrome framebuffer.
 #define SSD1306_W 128
 #define SSD1306_H 64
 #define SSD1306_A ( SSD1306_W * SSD1306_H ) / 8
-uint8_t FRAMEBUFFER[ SSD1306_A ];
+// Two framebuffers: DMA sends the 'front' one to the display
+// while the application draws to the 'back' one.
+uint8_t FRAMEBUFFERS[ 2 ][ SSD1306_A ] DMA_ALIGNED;
+// DMA1 channel 1 sends every I2C transfer.
+DMA_CLAIM( 1, 1 );
+// Index of the framebuffer which DMA is currently sending.
+volatile uint8_t front_buf = 0;
+// Pointer to the framebuffer which the application draws to.
+uint8_t *FRAMEBUFFER = FRAMEBUFFERS[ 1 ];
+// Commands to send before each display RAM update. Setting the
+// column and page address ranges also resets the display's RAM
+// pointers, so a dropped byte can only corrupt a single update.
+// Each command byte is prefixed with '0x80' (Co=1) so that more
+// control bytes can follow it in the same I2C transfer.
+#define NUM_WINDOW_CMDS 13
+#define WINDOW_C0 ( 3 )
+#define WINDOW_C1 ( 5 )
+#define WINDOW_P0 ( 9 )
+#define WINDOW_P1 ( 11 )
+uint8_t WINDOW_CMDS[ NUM_WINDOW_CMDS ] = {
+  // Column address range: [0:127].
+  0x80, 0x21, 0x80, 0x00, 0x80, SSD1306_W - 1,
+  // Page address range: [0:7].
+  0x80, 0x22, 0x80, 0x00, 0x80, ( SSD1306_H / 8 ) - 1,
+  // 0x40, to indicate that the rest of the transfer is data.
+  0x40
+};
+// Source and length of the pending display RAM update.
+const uint8_t *update_src = 0;
+uint16_t update_len = 0;
+volatile uint8_t update_pending = 0;
+// Single column of pixels, gathered from the front framebuffer.
+uint8_t COLUMN_BUF[ SSD1306_H / 8 ];
+// Queued command bytes, for scrolling and start line changes.
+#define MAX_QUEUED_CMDS 9
+uint8_t QUEUED_CMDS[ MAX_QUEUED_CMDS ];
+uint8_t queued_len = 0;
+volatile uint8_t cmds_pending = 0;
+// One contiguous span of memory to send in an I2C transfer.
+typedef struct {
+  const uint8_t *src;
+  uint16_t       len;
+} tx_seg_t;
+// Segments of the current I2C transfer. The DMA 'transfer
+// complete' interrupt points the channel at the next segment,
+// so that a transfer can be gathered from several buffers
+// without copying them together first.
+#define MAX_TX_SEGS 2
+tx_seg_t TX_SEGS[ MAX_TX_SEGS ];
+volatile uint8_t tx_seg = 0;
+uint8_t tx_segs = 0;
+// I2C transfer states. Each display RAM update is sent as one
+// I2C transfer: the window commands and '0x40' from one segment,
+// then the data straight from the framebuffer.
+// The bus is left idle when nothing needs to be sent.
+#define FRAME_TX_IDLE   ( 0 )
+#define FRAME_TX_QUEUED ( 1 )
+#define FRAME_TX_UPDATE ( 2 )
+volatile uint8_t frame_tx = FRAME_TX_IDLE;
+// Number of bytes in the current I2C transfer which have not
+// been loaded into the 'NBYTES' field yet.
+volatile uint16_t frame_left = 0;
 // Initialization commands for the SSD1306 display.
 #define NUM_INIT_CMDS 25
 const uint8_t INIT_CMDS[ NUM_INIT_CMDS ] = {
@@ -31,139 +99,413 @@ const uint8_t INIT_CMDS[ NUM_INIT_CMDS ] = {
 // Global variable to hold the core clock speed in Hertz.
 uint32_t SystemCoreClock = 16000000;
 
-// Simple imprecise delay method.
-void __attribute__( ( optimize( "O0" ) ) )
-delay_cycles( uint32_t cyc ) {
-  for ( uint32_t d_i = 0; d_i < cyc; ++d_i ) { asm( "NOP" ); }
+// Point DMA channel 1 at a segment of the current transfer.
+RAMFUNC void frame_load_seg( const tx_seg_t *seg ) {
+  DMA_DISABLE( 1, 1 );
+  DMA_MAR( 1, 1 )  = ( uint32_t )seg->src;
+  DMA_NDTR( 1, 1 ) = ( uint16_t )seg->len;
+  DMA_ENABLE( 1, 1 );
+}
+
+// Start sending the segments in 'TX_SEGS' as one I2C transfer.
+// (DMA ch1 and I2C2 must be idle when this is called)
+RAMFUNC void frame_start( uint8_t num_segs ) {
+  uint16_t total = 0;
+  for ( uint8_t i = 0; i < num_segs; ++i ) {
+    total += TX_SEGS[ i ].len;
+  }
+  tx_segs = num_segs;
+  tx_seg  = 0;
+  frame_load_seg( &TX_SEGS[ 0 ] );
+  // 'NBYTES' can only hold up to 255, so longer transfers use
+  // 'reload' mode and refill it in the TCR interrupt. The last
+  // chunk ends with an automatic STOP.
+  uint32_t cr2;
+  if ( total > 255 ) {
+    frame_left = total - 255;
+    cr2 = ( 255 << I2C_CR2_NBYTES_Pos |
+            I2C_CR2_RELOAD );
+  }
+  else {
+    frame_left = 0;
+    cr2 = ( total << I2C_CR2_NBYTES_Pos |
+            I2C_CR2_AUTOEND );
+  }
+  // Send a start signal, in the same write as the byte count.
+  REG_SET( I2C2->CR2, ( I2C_CR2_NBYTES |
+                        I2C_CR2_RELOAD |
+                        I2C_CR2_AUTOEND ),
+                      ( cr2 | I2C_CR2_START ) );
+}
+
+// Start the next pending I2C transfer, or go idle. Queued
+// commands are sent before display RAM updates.
+RAMFUNC void frame_next( void ) {
+  if ( cmds_pending ) {
+    frame_tx = FRAME_TX_QUEUED;
+    TX_SEGS[ 0 ].src = QUEUED_CMDS;
+    TX_SEGS[ 0 ].len = queued_len;
+    frame_start( 1 );
+  }
+  else if ( update_pending ) {
+    frame_tx = FRAME_TX_UPDATE;
+    TX_SEGS[ 0 ].src = WINDOW_CMDS;
+    TX_SEGS[ 0 ].len = NUM_WINDOW_CMDS;
+    TX_SEGS[ 1 ].src = update_src;
+    TX_SEGS[ 1 ].len = update_len;
+    frame_start( 2 );
+  }
+  else {
+    frame_tx = FRAME_TX_IDLE;
+  }
+}
+
+// Start sending if the bus is idle. The I2C2 interrupt is masked
+// so that it cannot start a transfer at the same time.
+void frame_kick( void ) {
+  NVIC_DisableIRQ( I2C2_IRQn );
+  if ( frame_tx == FRAME_TX_IDLE ) { frame_next(); }
+  NVIC_EnableIRQ( I2C2_IRQn );
+}
+
+// Fill the back buffer with one byte value.
+RAMFUNC void fb_fill( uint8_t val ) {
+  for ( size_t i = 0; i < SSD1306_A; ++i ) {
+    FRAMEBUFFER[ i ] = val;
+  }
+}
+
+// Send command bytes to the display, after any display RAM
+// update which is currently in progress. Returns once they
+// have been sent, so calls are applied in program order.
+// Returns 0 on success, or -1 without sending anything if the
+// list does not fit in the queue.
+int ssd1306_cmds( const uint8_t *cmds, uint8_t len ) {
+  if ( len >= MAX_QUEUED_CMDS ) { return -1; }
+  QUEUED_CMDS[ 0 ] = 0x00;
+  for ( uint8_t i = 0; i < len; ++i ) {
+    QUEUED_CMDS[ i + 1 ] = cmds[ i ];
+  }
+  queued_len = len + 1;
+  cmds_pending = 1;
+  frame_kick();
+  while ( cmds_pending ) { sleep_idle(); }
+  return 0;
+}
+
+// Set the display RAM row which is shown on the top line. This
+// scrolls the whole display vertically without resending any
+// pixel data; only the newly-exposed rows need to be redrawn.
+void ssd1306_start_line( uint8_t line ) {
+  uint8_t cmd = 0x40 | ( line & 0x3F );
+  ssd1306_cmds( &cmd, 1 );
+}
+
+// Start continuous horizontal scrolling of pages [p0:p1].
+// 'left' selects command 0x27 instead of 0x26, and 'interval'
+// is the 3-bit frame interval code from the datasheet.
+// Display RAM should not be written while scrolling is active.
+void ssd1306_scroll_h( uint8_t left, uint8_t p0, uint8_t p1,
+                       uint8_t interval ) {
+  const uint8_t cmds[ 8 ] = {
+    left ? 0x27 : 0x26, 0x00, p0, interval, p1, 0x00, 0xFF,
+    // Activate scrolling.
+    0x2F
+  };
+  ssd1306_cmds( cmds, 8 );
+}
+
+// Start continuous vertical and horizontal scrolling of pages
+// [p0:p1], moving 'v_offset' rows per step. Vertical scrolling
+// applies to the rows set with 'ssd1306_scroll_area'.
+void ssd1306_scroll_vh( uint8_t left, uint8_t p0, uint8_t p1,
+                        uint8_t interval, uint8_t v_offset ) {
+  const uint8_t cmds[ 7 ] = {
+    left ? 0x2A : 0x29, 0x00, p0, interval, p1, v_offset & 0x3F,
+    // Activate scrolling.
+    0x2F
+  };
+  ssd1306_cmds( cmds, 7 );
+}
+
+// Set the range of rows which scroll vertically: 'top' fixed
+// rows, followed by 'rows' scrolling rows.
+void ssd1306_scroll_area( uint8_t top, uint8_t rows ) {
+  const uint8_t cmds[ 3 ] = { 0xA3, top, rows };
+  ssd1306_cmds( cmds, 3 );
+}
+
+// Stop any continuous scrolling. The display RAM must be
+// rewritten afterwards, if horizontal scrolling moved it.
+void ssd1306_scroll_stop( void ) {
+  const uint8_t cmd = 0x2E;
+  ssd1306_cmds( &cmd, 1 );
+}
+
+// Wait for the previous display RAM update to finish.
+void frame_wait( void ) {
+  while ( update_pending ) { sleep_idle(); }
+}
+
+// Swap the front and back buffers once the previous display RAM
+// update has finished. Returns a pointer to the new front buffer.
+// The caller copies whatever it is about to display back into
+// the new back buffer, so that it can be drawn on incrementally.
+uint8_t *frame_swap( void ) {
+  frame_wait();
+  front_buf ^= 1;
+  FRAMEBUFFER = FRAMEBUFFERS[ front_buf ^ 1 ];
+  return FRAMEBUFFERS[ front_buf ];
+}
+
+// Display pages [p0:p1] of the back buffer. Each page is a
+// full-width 8-pixel row, so a page range is one contiguous
+// span of the framebuffer.
+void present_pages( uint8_t p0, uint8_t p1 ) {
+  uint8_t *front = frame_swap();
+  for ( size_t i = p0 * SSD1306_W; i < ( p1 + 1 ) * SSD1306_W; ++i ) {
+    FRAMEBUFFER[ i ] = front[ i ];
+  }
+  WINDOW_CMDS[ WINDOW_C0 ] = 0x00;
+  WINDOW_CMDS[ WINDOW_C1 ] = SSD1306_W - 1;
+  WINDOW_CMDS[ WINDOW_P0 ] = p0;
+  WINDOW_CMDS[ WINDOW_P1 ] = p1;
+  update_src = &front[ p0 * SSD1306_W ];
+  update_len = ( p1 - p0 + 1 ) * SSD1306_W;
+  update_pending = 1;
+  frame_kick();
+}
+
+// Display a single column of the back buffer. This only sends
+// 8 data bytes, for graphs which scroll horizontally. Nothing
+// outside of column 'col' should have been drawn since the last
+// update, because only that column is copied between buffers.
+void present_column( uint8_t col ) {
+  uint8_t *front = frame_swap();
+  for ( size_t i = 0; i < ( SSD1306_H / 8 ); ++i ) {
+    COLUMN_BUF[ i ] = front[ ( i * SSD1306_W ) + col ];
+    FRAMEBUFFER[ ( i * SSD1306_W ) + col ] = COLUMN_BUF[ i ];
+  }
+  WINDOW_CMDS[ WINDOW_C0 ] = col;
+  WINDOW_CMDS[ WINDOW_C1 ] = col;
+  WINDOW_CMDS[ WINDOW_P0 ] = 0x00;
+  WINDOW_CMDS[ WINDOW_P1 ] = ( SSD1306_H / 8 ) - 1;
+  update_src = COLUMN_BUF;
+  update_len = SSD1306_H / 8;
+  update_pending = 1;
+  frame_kick();
+}
+
+// Display the whole back buffer.
+void present( void ) {
+  present_pages( 0, ( SSD1306_H / 8 ) - 1 );
+}
+
+// Demo: patterns of horizontal lines. The display is configured
+// to hold 8 vertical pixels in each byte, with the first 128
+// bytes representing y-coordinates [0:7], the next 128 bytes
+// [8:15], and so on. So if we set each byte to the same value,
+// it will look like a pattern of horizontal lines of varying
+// thickness. Each frame's drawing time is recorded in
+// 'bench_results'.
+void demo_lines( void ) {
+  for ( uint16_t val = 0x00; val <= 0xFF; val += 0x11 ) {
+    uint32_t start = bench_start();
+    fb_fill( val );
+    bench_stop( "fill", start );
+    present();
+    sleep_ms( 100 );
+  }
+}
+
+// Demo: a triangle wave graph, drawn one column at a time.
+// The display's start line moves up by one row every time the
+// graph wraps around, to show vertical scrolling without
+// resending any pixel data.
+void demo_graph( void ) {
+  fb_fill( 0x00 );
+  present();
+  for ( uint16_t t = 0; t < ( SSD1306_W * 4 ); ++t ) {
+    uint8_t col = t % SSD1306_W;
+    uint8_t ph  = ( t * 3 ) % ( SSD1306_H * 2 );
+    uint8_t y   = ( ph < SSD1306_H ) ? ph : ( ( SSD1306_H * 2 ) - 1 - ph );
+    for ( size_t i = 0; i < ( SSD1306_H / 8 ); ++i ) {
+      FRAMEBUFFER[ ( i * SSD1306_W ) + col ] = 0x00;
+    }
+    FRAMEBUFFER[ ( ( y / 8 ) * SSD1306_W ) + col ] = ( 1 << ( y & 7 ) );
+    present_column( col );
+    if ( col == ( SSD1306_W - 1 ) ) {
+      ssd1306_start_line( ( t / SSD1306_W ) + 1 );
+    }
+    sleep_ms( 10 );
+  }
+  ssd1306_start_line( 0 );
+}
+
+// Demo: hardware scrolling. Draws a checkerboard, scrolls all of
+// it to the right, then scrolls the bottom half diagonally with
+// the top 16 rows held in place.
+void demo_scroll( void ) {
+  for ( size_t i = 0; i < SSD1306_A; ++i ) {
+    FRAMEBUFFER[ i ] = ( ( ( i / 8 ) + ( i / SSD1306_W ) ) & 1 ) ? 0xFF : 0x00;
+  }
+  present();
+  // Wait for the update to finish; display RAM should not be
+  // written while scrolling is active.
+  frame_wait();
+  ssd1306_scroll_h( 0, 0, ( SSD1306_H / 8 ) - 1, 0x07 );
+  sleep_ms( 2000 );
+  ssd1306_scroll_stop();
+  // Horizontal scrolling moved the display RAM, so rewrite it.
+  present();
+  frame_wait();
+  ssd1306_scroll_area( 16, SSD1306_H - 16 );
+  ssd1306_scroll_vh( 1, 2, ( SSD1306_H / 8 ) - 1, 0x00, 1 );
+  sleep_ms( 2000 );
+  ssd1306_scroll_stop();
 }
 
 /**
  * Main program.
  */
 int main(void) {
+  // Run the core at its highest rated speed, and start the
+  // millisecond timer.
+  clock_init( CLOCK_MAX_HZ );
+  sleep_init();
+
   // Enable peripherals: GPIOA, DMA, I2C2.
   RCC->IOPENR   |= RCC_IOPENR_GPIOAEN;
   RCC->AHBENR   |= RCC_AHBENR_DMA1EN;
   RCC->APBENR1  |= RCC_APBENR1_I2C2EN;
 
   // Pin A11/12 output type: Alt. Func. #6.
-  GPIOA->MODER    &= ~( 0x3 << ( 11 * 2 ) |
-                        0x3 << ( 12 * 2 ) );
-  GPIOA->MODER    |=  ( 0x2 << ( 11 * 2 ) |
-                        0x2 << ( 12 * 2 ) );
-  GPIOA->AFR[ 1 ] &= ~( GPIO_AFRH_AFSEL11 |
-                        GPIO_AFRH_AFSEL12 );
-  GPIOA->AFR[ 1 ] |=  ( 0x6 << GPIO_AFRH_AFSEL11_Pos |
-                        0x6 << GPIO_AFRH_AFSEL12_Pos );
+  REG_SET( GPIOA->MODER, ( 0x3 << ( 11 * 2 ) |
+                           0x3 << ( 12 * 2 ) ),
+                         ( 0x2 << ( 11 * 2 ) |
+                           0x2 << ( 12 * 2 ) ) );
+  REG_SET( GPIOA->AFR[ 1 ], ( GPIO_AFRH_AFSEL11 |
+                              GPIO_AFRH_AFSEL12 ),
+                            ( 0x6 << GPIO_AFRH_AFSEL11_Pos |
+                              0x6 << GPIO_AFRH_AFSEL12_Pos ) );
 
   // DMA configuration (channel 1).
-  // CCR register:
+  // - I2C2 transmit requests, through DMAMUX channel 0.
   // - Memory-to-peripheral
   // - Circular mode disabled.
   // - Increment memory ptr, don't increment periph ptr.
   // - 8-bit data size for both source and destination.
   // - High priority.
-  DMA1_Channel1->CCR &= ~( DMA_CCR_MEM2MEM |
-                           DMA_CCR_PL |
-                           DMA_CCR_MSIZE |
-                           DMA_CCR_PSIZE |
-                           DMA_CCR_PINC |
-                           DMA_CCR_CIRC |
-                           DMA_CCR_EN );
-  DMA1_Channel1->CCR |=  ( ( 0x2 << DMA_CCR_PL_Pos ) |
-                           DMA_CCR_MINC |
-                           DMA_CCR_DIR );
-  // Route DMA channel 0 to I2C2 transmit.
-  DMAMUX1_Channel0->CCR &= ~( DMAMUX_CxCR_DMAREQ_ID );
-  DMAMUX1_Channel0->CCR |=  ( 13 << DMAMUX_CxCR_DMAREQ_ID_Pos );
-  // Set DMA source and destination addresses.
   // Source: Address of the initialization commands.
-  DMA1_Channel1->CMAR  = ( uint32_t )&INIT_CMDS;
   // Dest.: 'I2C2 transmit' register.
-  DMA1_Channel1->CPAR  = ( uint32_t )&( I2C2->TXDR );
-  // Set DMA data transfer length (# of init commands).
-  DMA1_Channel1->CNDTR = ( uint16_t )NUM_INIT_CMDS;
+  // Length: # of init commands.
+  DMA_INIT( 1, 1, DMA_REQ_I2C2_TX,
+            DMA_CFG( DMA_M2P, DMA_8BIT, DMA_8BIT, 2, DMA_MINC ),
+            &INIT_CMDS, &( I2C2->TXDR ), NUM_INIT_CMDS );
   // Enable DMA1 Channel 1.
-  DMA1_Channel1->CCR |= ( DMA_CCR_EN );
+  DMA_ENABLE( 1, 1 );
 
   // I2C2 configuration:
   // Timing register. For "Fast-Mode+" (1MHz), the RM says:
   // (@16MHz) presc=0, SCLL=4, SCLH=2, SDADEL=0, SCLDEL=2.
-  I2C2->TIMINGR  = 0x00200204;
+  // The prescaler divides faster bus clocks down to 16MHz, so
+  // the same counts work at any multiple of it.
+  I2C2->TIMINGR  = ( ( ( clock_apb1_hz() / 16000000 ) - 1 )
+                     << I2C_TIMINGR_PRESC_Pos ) | 0x00200204;
   // Enable the peripheral.
   I2C2->CR1     |= I2C_CR1_PE;
   // Set the device address. Usually 0x78, can be 0x7A.
   // The I2C peripheral also needs to know how many bytes
   // to send before it starts transmitting.
-  I2C2->CR2     &= ~( I2C_CR2_SADD |
-                      I2C_CR2_NBYTES );
-  I2C2->CR2     |=  ( 0x7A << I2C_CR2_SADD_Pos |
-                      NUM_INIT_CMDS << I2C_CR2_NBYTES_Pos );
+  REG_SET( I2C2->CR2, ( I2C_CR2_SADD |
+                        I2C_CR2_NBYTES ),
+                      ( 0x7A << I2C_CR2_SADD_Pos |
+                        NUM_INIT_CMDS << I2C_CR2_NBYTES_Pos ) );
   // Enable I2C DMA requests.
   I2C2->CR1     |=  ( I2C_CR1_TXDMAEN );
   // Send a start signal.
   I2C2->CR2     |=  ( I2C_CR2_START );
   // (DMA is now running.)
   // Wait for DMA to finish.
-  while ( !( DMA1->ISR & DMA_ISR_TCIF1 ) ) {};
-  DMA1->IFCR |= DMA_IFCR_CTCIF1;
+  while ( !( DMA_FLAGS( 1, 1 ) & DMA_TC_FLAG( 1 ) ) ) {};
+  DMA_CLEAR( 1, 1, DMA_TC_FLAG( 1 ) );
   // Stop the I2C transmission.
   while ( !( I2C2->ISR & I2C_ISR_TC ) ) {};
   I2C2->CR2  |=  ( I2C_CR2_STOP );
   while ( I2C2->ISR & I2C_ISR_BUSY ) {};
+  // Clear the 'STOP detected' flag before enabling its interrupt.
+  I2C2->ICR  |=  ( I2C_ICR_STOPCF );
 
-  // Reconfigure DMA and I2C for sending the framebuffer.
+  // Reconfigure DMA and I2C for sending frames.
   // Disable the DMA channel.
-  DMA1_Channel1->CCR &= ~( DMA_CCR_EN );
-  // Set DMA circular mode.
-  DMA1_Channel1->CCR |=  ( DMA_CCR_CIRC );
-  // Set I2C autoreload and the maximum 255 byte length.
-  I2C2->CR2      &= ~( I2C_CR2_NBYTES );
-  I2C2->CR2      |=  ( I2C_CR2_RELOAD |
-                       255 << I2C_CR2_NBYTES_Pos );
+  DMA_DISABLE( 1, 1 );
+  // Enable the DMA1 channel 1 'transfer complete' interrupt,
+  // which moves the channel on to the next transfer segment.
+  // It has a higher priority than the I2C interrupt.
+  NVIC_SetPriority( DMA1_Channel1_IRQn, 0x02 );
+  NVIC_EnableIRQ( DMA1_Channel1_IRQn );
+  DMA_CR( 1, 1 )    |=  ( DMA_TCIE );
   // Enable the I2C2 interrupt.
   NVIC_SetPriority( I2C2_IRQn, 0x03 );
   NVIC_EnableIRQ( I2C2_IRQn );
-  // Enable the 'transfer complete' I2C interrupt.
-  I2C2->CR1      |= I2C_CR1_TCIE;
-  // Update DMA source/destination/size registers.
-  // Source: Address of the framebuffer.
-  DMA1_Channel1->CMAR  = ( uint32_t )&FRAMEBUFFER;
-  // Dest.: 'I2C2 transmit' register.
-  DMA1_Channel1->CPAR  = ( uint32_t )&( I2C2->TXDR );
-  // Set DMA data transfer length (framebuffer length).
-  DMA1_Channel1->CNDTR = ( uint16_t )SSD1306_A;
-  // Send a start signal.
-  I2C2->CR2     |=  ( I2C_CR2_START );
-  while ( !( I2C2->CR2 & I2C_CR2_START ) ) {};
-  // Send '0x40' to indicate display data.
-  I2C2->TXDR = 0x40;
-  // Re-enable DMA1 Channel 1.
-  DMA1_Channel1->CCR |= ( DMA_CCR_EN );
-
-  // Done; now draw patterns to the framebuffer.
-  // The display is configured to hold 8 vertical pixels in
-  // each byte, with the first 128 bytes representing
-  // y-coordinates [0:7], the next 128 bytes [8:15], and so on.
-  // So if we set each byte to the same value, it will look
-  // like a pattern of horizontal lines of varying thickness.
-  uint8_t val = 0x00;
+  // Enable the 'transfer complete reload' and 'STOP detected'
+  // I2C interrupts. The interrupt handler starts each transfer
+  // when the previous one ends.
+  I2C2->CR1      |= ( I2C_CR1_TCIE |
+                      I2C_CR1_STOPIE );
+
+  // Done; now cycle through the demos.
+  bench_init();
   while (1) {
-    // Draw the new pattern to the framebuffer.
-    for ( size_t i = 0; i < SSD1306_A; ++i ) {
-      FRAMEBUFFER[ i ] = val;
-    }
-    // Update the pattern.
-    ++val;
-    // Delay briefly.
-    delay_cycles( 200000 );
+    demo_lines();
+    demo_graph();
+    demo_scroll();
   }
 }
 
 // I2C2 interrupt handler.
-void I2C2_IRQ_handler( void ) {
+RAMFUNC void I2C2_IRQ_handler( void ) {
   if ( I2C2->ISR & I2C_ISR_TCR ) {
-    I2C2->CR2 &= ~( I2C_CR2_NBYTES );
-    I2C2->CR2 |=  ( 255 << I2C_CR2_NBYTES_Pos );
+    // Load the next chunk of the framebuffer transfer, and
+    // end it with an automatic STOP if it is the last one.
+    if ( frame_left > 255 ) {
+      REG_SET( I2C2->CR2, ( I2C_CR2_NBYTES ),
+                          ( 255 << I2C_CR2_NBYTES_Pos ) );
+      frame_left -= 255;
+    }
+    else {
+      REG_SET( I2C2->CR2, ( I2C_CR2_NBYTES |
+                            I2C_CR2_RELOAD ),
+                          ( frame_left << I2C_CR2_NBYTES_Pos |
+                            I2C_CR2_AUTOEND ) );
+      frame_left = 0;
+    }
+  }
+  if ( I2C2->ISR & I2C_ISR_STOPF ) {
+    I2C2->ICR |=  ( I2C_ICR_STOPCF );
+    if ( frame_tx == FRAME_TX_QUEUED ) {
+      cmds_pending = 0;
+      frame_next();
+    }
+    else if ( frame_tx == FRAME_TX_UPDATE ) {
+      // The update is finished; the front and back buffers can
+      // be swapped again.
+      update_pending = 0;
+      frame_next();
+    }
+  }
+}
+
+// DMA1 channel 1 interrupt handler.
+RAMFUNC void DMA1_chan1_IRQ_handler( void ) {
+  if ( DMA_FLAGS( 1, 1 ) & DMA_TC_FLAG( 1 ) ) {
+    DMA_CLEAR( 1, 1, DMA_TC_FLAG( 1 ) );
+    // Move on to the next segment of the I2C transfer, if any.
+    // The I2C peripheral stretches the clock until DMA writes
+    // the next byte, so the gap does not break the transfer.
+    if ( ( tx_seg + 1 ) < tx_segs ) {
+      ++tx_seg;
+      frame_load_seg( &TX_SEGS[ tx_seg ] );
+    }
   }
 }
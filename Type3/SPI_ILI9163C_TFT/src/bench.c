@@ -0,0 +1,94 @@
+#include "bench.h"
+
+#if defined( VVC_HOST )
+  #include <time.h>
+#endif
+
+// Core clock speed in Hertz, for host timings.
+extern uint32_t SystemCoreClock;
+
+bench_t bench_results[ BENCH_MAX ];
+size_t  bench_num = 0;
+// (Set by the reset handler, after '.bss' has been cleared)
+uint32_t boot_cycles = 0;
+// Cycles taken by an empty start / stop pair, which are not
+// counted against the kernel.
+static uint32_t bench_overhead = 0;
+
+#if defined( VVC_HOST )
+static struct timespec bench_t0;
+
+// Host cycle counter: time since 'bench_init', at the core clock.
+uint32_t bench_cycles( void ) {
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  uint64_t ns = ( uint64_t )( now.tv_sec - bench_t0.tv_sec ) * 1000000000ULL +
+                ( uint64_t )( now.tv_nsec - bench_t0.tv_nsec );
+  return ( uint32_t )( ( ns * SystemCoreClock ) / 1000000000ULL );
+}
+#endif
+
+// Start the cycle counter, clear the results table, and measure
+// the timing overhead.
+void bench_init( void ) {
+#if defined( VVC_HOST )
+  clock_gettime( CLOCK_MONOTONIC, &bench_t0 );
+#elif ( __CORTEX_M >= 0x03U )
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT       = 0;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#else
+  // Run SysTick as a free-running 24-bit counter at the core
+  // clock speed.
+  SysTick->LOAD = 0x00FFFFFF;
+  SysTick->VAL  = 0;
+  SysTick->CTRL = ( SysTick_CTRL_CLKSOURCE_Msk |
+                    SysTick_CTRL_ENABLE_Msk );
+#endif
+  bench_num = 0;
+  bench_overhead = 0;
+  uint32_t start = bench_start();
+  bench_overhead = ( bench_cycles() - start ) & BENCH_MASK;
+}
+
+// Compare two kernel names. (No C library is linked)
+static int bench_same( const char *a, const char *b ) {
+  if ( a == b ) { return 1; }
+  while ( *a && ( *a == *b ) ) { ++a; ++b; }
+  return ( *a == *b );
+}
+
+// Add one run of a kernel to the results table. Kernels which
+// do not fit in the table are not recorded.
+void bench_record( const char *name, uint32_t cycles ) {
+  bench_t *b = 0;
+  for ( size_t i = 0; i < bench_num; ++i ) {
+    if ( bench_same( bench_results[ i ].name, name ) ) {
+      b = &bench_results[ i ];
+      break;
+    }
+  }
+  if ( !b ) {
+    if ( bench_num >= BENCH_MAX ) { return; }
+    b = &bench_results[ bench_num++ ];
+    b->name  = name;
+    b->runs  = 0;
+    b->min   = 0xFFFFFFFF;
+    b->max   = 0;
+    b->total = 0;
+  }
+  ++b->runs;
+  b->last   = cycles;
+  b->total += cycles;
+  if ( cycles < b->min ) { b->min = cycles; }
+  if ( cycles > b->max ) { b->max = cycles; }
+}
+
+// Finish timing a kernel which started at 'start', record it
+// under 'name', and return the number of cycles which it took.
+uint32_t bench_stop( const char *name, uint32_t start ) {
+  uint32_t cycles = ( bench_cycles() - start ) & BENCH_MASK;
+  cycles = ( cycles > bench_overhead ) ? ( cycles - bench_overhead ) : 0;
+  bench_record( name, cycles );
+  return cycles;
+}
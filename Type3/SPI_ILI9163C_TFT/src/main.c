@@ -3,12 +3,21 @@
 #include <stdlib.h>
 // Vendor-provided device header file.
 #include "stm32g0xx.h"
+// Project includes.
+#include "dma.h"
+#include "reg.h"
+#include "sections.h"
+#include "bench.h"
+#include "sleep.h"
+#include "clock.h"
 
 // 128x128-pixel 16-bit (RGB-565) framebuffer.
 #define ILI9163C_W ( 128 )
 #define ILI9163C_H ( 128 )
 #define ILI9163C_A ( ILI9163C_W * ILI9163C_H )
-uint16_t FRAMEBUFFER[ ILI9163C_A ];
+uint16_t FRAMEBUFFER[ ILI9163C_A ] DMA_BUF;
+// DMA1 channel 1 sends it to the display.
+DMA_CLAIM( 1, 1 );
 // Macro definitions for 'command' (0) and 'data' (1) modes.
 #define ILI9163C_CMD ( 0 )
 #define ILI9163C_DAT ( 1 )
@@ -21,12 +30,6 @@ uint16_t FRAMEBUFFER[ ILI9163C_A ];
 // Global variable to hold the core clock speed in Hertz.
 uint32_t SystemCoreClock = 16000000;
 
-// Simple imprecise delay method.
-void __attribute__( ( optimize( "O0" ) ) )
-delay_cycles( uint32_t cyc ) {
-  for ( uint32_t d_i = 0; d_i < cyc; ++d_i ) { asm( "NOP" ); }
-}
-
 // Write a byte to the SPI peripheral.
 void spi_w8( SPI_TypeDef *SPIx, uint8_t dat ) {
   // Wait for TXE 'transmit buffer empty' bit to be set.
@@ -49,8 +52,15 @@ void dat_cmd( SPI_TypeDef *SPIx, uint8_t dc ) {
   // Wait for the BSY 'busy' bit to be cleared.
   while ( SPIx->SR & SPI_SR_BSY ) {};
   // Set the D/C pin appropriately.
-  if ( dc ) { GPIOB->ODR |=  ( TFT_DC ); }
-  else      { GPIOB->ODR &= ~( TFT_DC ); }
+  if ( dc ) { GPIOB->BSRR = ( TFT_DC ); }
+  else      { GPIOB->BRR  = ( TFT_DC ); }
+}
+
+// Fill the framebuffer with one color.
+RAMFUNC void fb_fill( uint16_t color ) {
+  for ( size_t i = 0; i < ILI9163C_A; ++i ) {
+    FRAMEBUFFER[ i ] = color;
+  }
 }
 
 /**
@@ -62,111 +72,79 @@ int main(void) {
   RCC->AHBENR   |= RCC_AHBENR_DMA1EN;
   RCC->APBENR2  |= RCC_APBENR2_SPI1EN;
 
-  // Setup core clock to 64MHz.
-  // Set 2 wait states in Flash.
-  FLASH->ACR &= ~( FLASH_ACR_LATENCY );
-  FLASH->ACR |=  ( 2 << FLASH_ACR_LATENCY_Pos );
-  // Configure PLL; R = 2, M = 1, N = 8.
-  // freq = ( 16MHz * ( N / M ) ) / R
-  RCC->PLLCFGR &= ~( RCC_PLLCFGR_PLLR |
-                     RCC_PLLCFGR_PLLREN |
-                     RCC_PLLCFGR_PLLN |
-                     RCC_PLLCFGR_PLLM |
-                     RCC_PLLCFGR_PLLSRC );
-  RCC->PLLCFGR |=  ( 1 << RCC_PLLCFGR_PLLR_Pos |
-                     8 << RCC_PLLCFGR_PLLN_Pos |
-                     RCC_PLLCFGR_PLLREN |
-                     2 << RCC_PLLCFGR_PLLSRC_Pos );
-  // Enable and select the PLL.
-  RCC->CR   |= RCC_CR_PLLON;
-  while ( !( RCC->CR & RCC_CR_PLLRDY ) ) {};
-  RCC->CFGR &= ~( RCC_CFGR_SW );
-  RCC->CFGR |=  ( 2 << RCC_CFGR_SW_Pos );
-  while ( ( RCC->CFGR & RCC_CFGR_SWS ) >> RCC_CFGR_SWS_Pos != 2 ) {};
-  // System clock is now 64MHz.
-  SystemCoreClock = 64000000;
+  // Run the core at its highest rated speed. (64MHz)
+  clock_init( CLOCK_MAX_HZ );
 
   // Setup pins: B3/5 are AF#0 (SPI1) (SCK/SDO),
   // B4 = CS, B6 = Reset, B7 = D/C.
-  GPIOB->MODER    &= ~( 0x3 << ( 3 * 2 ) |
-                        0x3 << ( 4 * 2 ) |
-                        0x3 << ( 5 * 2 ) |
-                        0x3 << ( 6 * 2 ) |
-                        0x3 << ( 7 * 2 ) );
-  GPIOB->MODER    |=  ( 0x2 << ( 3 * 2 ) |
-                        0x1 << ( 4 * 2 ) |
-                        0x2 << ( 5 * 2 ) |
-                        0x1 << ( 6 * 2 ) |
-                        0x1 << ( 7 * 2 ) );
+  REG_SET( GPIOB->MODER, ( 0x3 << ( 3 * 2 ) |
+                           0x3 << ( 4 * 2 ) |
+                           0x3 << ( 5 * 2 ) |
+                           0x3 << ( 6 * 2 ) |
+                           0x3 << ( 7 * 2 ) ),
+                         ( 0x2 << ( 3 * 2 ) |
+                           0x1 << ( 4 * 2 ) |
+                           0x2 << ( 5 * 2 ) |
+                           0x1 << ( 6 * 2 ) |
+                           0x1 << ( 7 * 2 ) ) );
   GPIOB->AFR[ 0 ] &= ~( GPIO_AFRL_AFSEL3 |
                         GPIO_AFRL_AFSEL5 );
-  // Initial pin states: DC low, CS/Reset high.
-  GPIOB->ODR      &= ~( TFT_DC );
-  GPIOB->ODR      |=  ( TFT_CS | TFT_RST );
+  // Initial pin states: DC low, CS/Reset high. ('BSRR' sets
+  // pins with its low half, and resets them with its high half)
+  GPIOB->BSRR = ( TFT_CS | TFT_RST | ( TFT_DC << 16 ) );
 
   // DMA configuration (channel 1).
-  // CCR register:
+  // - SPI1 transmit requests, through DMAMUX channel 0.
   // - Memory-to-peripheral
   // - Circular mode enabled.
   // - Increment memory ptr, don't increment periph ptr.
   // - 16-bit data size for both source and destination.
   // - High priority.
-  DMA1_Channel1->CCR &= ~( DMA_CCR_MEM2MEM |
-                           DMA_CCR_PL |
-                           DMA_CCR_MSIZE |
-                           DMA_CCR_PSIZE |
-                           DMA_CCR_PINC |
-                           DMA_CCR_EN );
-  DMA1_Channel1->CCR |=  ( ( 0x2 << DMA_CCR_PL_Pos ) |
-                           ( 0x1 << DMA_CCR_MSIZE_Pos ) |
-                           ( 0x1 << DMA_CCR_PSIZE_Pos ) |
-                           DMA_CCR_MINC |
-                           DMA_CCR_CIRC |
-                           DMA_CCR_DIR );
-  // Route DMA channel 0 to SPI1 transmit.
-  DMAMUX1_Channel0->CCR &= ~( DMAMUX_CxCR_DMAREQ_ID );
-  DMAMUX1_Channel0->CCR |=  ( 17 << DMAMUX_CxCR_DMAREQ_ID_Pos );
-  // Set DMA source and destination addresses.
   // Source: Address of the framebuffer.
-  DMA1_Channel1->CMAR  = ( uint32_t )&FRAMEBUFFER;
   // Destination: SPI1 data register.
-  DMA1_Channel1->CPAR  = ( uint32_t )&( SPI1->DR );
-  // Set DMA data transfer length (framebuffer length).
-  DMA1_Channel1->CNDTR = ( uint16_t )ILI9163C_A;
+  // Length: framebuffer length.
+  DMA_INIT( 1, 1, DMA_REQ_SPI1_TX,
+            DMA_CFG( DMA_M2P, DMA_16BIT, DMA_16BIT, 2,
+                     DMA_MINC | DMA_CIRC ),
+            &FRAMEBUFFER, &( SPI1->DR ), ILI9163C_A );
+
+  // Start the millisecond timer, now that the core clock is set.
+  sleep_init();
 
   // Toggle pin B6 to reset the display.
-  GPIOB->ODR &= ~( TFT_RST );
-  delay_cycles( 200000 );
-  GPIOB->ODR |=  ( TFT_RST );
+  GPIOB->BRR  = ( TFT_RST );
+  sleep_ms( 10 );
+  GPIOB->BSRR = ( TFT_RST );
 
   // SPI1 configuration:
   // - Clock phase/polarity: 1/1
   // - Assert internal CS signal (software CS pin control)
   // - MSB-first
   // - 8-bit frames
-  // - Baud rate prescaler of 4 (or 128 for debugging)
+  // - Fastest baud rate up to 16MHz (a prescaler of 4 at 64MHz)
   // - TX DMA requests enabled.
-  SPI1->CR1 &= ~( SPI_CR1_LSBFIRST |
-                  SPI_CR1_BR );
-  SPI1->CR1 |=  ( SPI_CR1_SSM |
-                  SPI_CR1_SSI |
-                  0x1 << SPI_CR1_BR_Pos |
-                  SPI_CR1_MSTR |
-                  SPI_CR1_CPOL |
-                  SPI_CR1_CPHA );
-  SPI1->CR2 &= ~( SPI_CR2_DS );
-  SPI1->CR2 |=  ( 0x7 << SPI_CR2_DS_Pos |
-                  SPI_CR2_TXDMAEN );
+  REG_SET( SPI1->CR1, ( SPI_CR1_LSBFIRST |
+                        SPI_CR1_BR ),
+                      ( SPI_CR1_SSM |
+                        SPI_CR1_SSI |
+                        clock_spi_br( clock_apb2_hz(), 16000000 )
+                          << SPI_CR1_BR_Pos |
+                        SPI_CR1_MSTR |
+                        SPI_CR1_CPOL |
+                        SPI_CR1_CPHA ) );
+  REG_SET( SPI1->CR2, ( SPI_CR2_DS ),
+                      ( 0x7 << SPI_CR2_DS_Pos |
+                        SPI_CR2_TXDMAEN ) );
   // Enable the SPI peripheral.
   SPI1->CR1 |=  ( SPI_CR1_SPE );
 
   // Send initialization commands.
   // Pull CS pin low.
-  GPIOB->ODR &= ~( TFT_CS );
+  GPIOB->BRR  = ( TFT_CS );
   // Software reset.
   dat_cmd( SPI1, ILI9163C_CMD );
   spi_w8( SPI1, 0x01 );
-  delay_cycles( 200000 );
+  sleep_ms( 120 );
   // Display off.
   spi_w8( SPI1, 0x28 );
   // Color mode: 16bpp.
@@ -176,10 +154,10 @@ int main(void) {
   // Exit sleep mode.
   dat_cmd( SPI1, ILI9163C_CMD );
   spi_w8( SPI1, 0x11 );
-  delay_cycles( 200000 );
+  sleep_ms( 120 );
   // Display on.
   spi_w8( SPI1, 0x29 );
-  delay_cycles( 200000 );
+  sleep_ms( 20 );
   // Set drawing window.
   // The displays I got are offset by a few pixels.
   // So instead of setting X/Y ranges of [0:127]...
@@ -200,20 +178,25 @@ int main(void) {
   // From now on, we'll only be sending pixel data.
   dat_cmd( SPI1, ILI9163C_DAT );
 
+  // Draw the first color before DMA starts reading the framebuffer.
+  // (It is in the '.dma' section, which is not cleared at startup)
+  uint16_t color = 0x1984;
+  fb_fill( color );
   // Enable DMA1 Channel 1 to start sending the framebuffer.
-  DMA1_Channel1->CCR |= ( DMA_CCR_EN );
+  DMA_ENABLE( 1, 1 );
 
   // Done; now just alternate between solid colors to get
   // a feel for the refresh speed.
-  uint16_t color = 0x1984;
+  // Each frame's drawing time is recorded in 'bench_results'.
+  bench_init();
   while (1) {
     // Draw the new color to the framebuffer.
-    for ( size_t i = 0; i < ILI9163C_A; ++i ) {
-      FRAMEBUFFER[ i ] = color;
-    }
+    uint32_t start = bench_start();
+    fb_fill( color );
+    bench_stop( "fill", start );
     // Invert the color.
     color = color ^ 0xFFFF;
     // Delay briefly.
-    delay_cycles( 2500000 );
+    sleep_ms( 250 );
   }
 }
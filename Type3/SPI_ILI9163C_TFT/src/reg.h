@@ -0,0 +1,14 @@
+#ifndef __VVC_REG_H
+#define __VVC_REG_H
+
+// Update some fields in a peripheral register with one volatile
+// read and one write: clear the 'clr' bits and set the 'set' bits
+// in the same store. This replaces separate '&= ~( clr )' and
+// '|= ( set )' statements, which read and write the register
+// twice and briefly leave it with the old fields cleared.
+// Both masks should be constants, so that they fold into one AND
+// and one OR.
+#define REG_SET( reg, clr, set ) \
+  ( ( reg ) = ( ( ( reg ) & ~( clr ) ) | ( set ) ) )
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef __VVC_SECTIONS_H
+#define __VVC_SECTIONS_H
+
+// Place a variable in the '.noinit' section, which the reset
+// handler does not clear. Its contents start out undefined, so
+// it must be written before it is read. (Host builds have no
+// such section, so their variables are cleared as usual)
+#if defined( VVC_HOST )
+  #define NOINIT
+#else
+  #define NOINIT __attribute__( ( section( ".noinit" ) ) )
+#endif
+
+// Alignment for DMA buffers: one 4-beat burst of words.
+#define DMA_ALIGN ( 16 )
+// Place a DMA buffer in the '.dma' section, in SRAM which DMA
+// can reach. Like 'NOINIT' buffers, it starts out undefined.
+#if defined( VVC_HOST )
+  #define DMA_BUF __attribute__( ( aligned( DMA_ALIGN ) ) )
+#else
+  #define DMA_BUF __attribute__( ( section( ".dma" ), \
+                                   aligned( DMA_ALIGN ) ) )
+#endif
+// Align a DMA buffer which must start out cleared, and leave it
+// in '.bss'.
+#define DMA_ALIGNED __attribute__( ( aligned( DMA_ALIGN ) ) )
+
+// Run a function from SRAM instead of flash. The reset handler
+// copies it with '.data', so it avoids the flash wait states on
+// G0 chips at 48-64MHz. Building with 'RAMFUNC=0' leaves it in
+// flash, to compare timings.
+// The tag is deliberately portable: shared sources use it on every
+// chip, and it does nothing on F3 and F4 chips, which run their
+// code from flash behind its prefetch buffer or 'ART' cache.
+#if defined( VVC_G0 ) && !defined( VVC_HOST ) && !defined( VVC_NO_RAMFUNC )
+  #define RAMFUNC __attribute__( ( section( ".ramfunc" ) ) )
+#else
+  #define RAMFUNC
+#endif
+
+// Place CPU-only data in CCM RAM, on chips which have it. It is
+// cleared at startup, so it must not have an initial value, and
+// DMA cannot reach it. (Elsewhere, it stays in '.bss')
+#if defined( VVC_F3 ) && !defined( VVC_HOST )
+  #define CCM_DATA __attribute__( ( section( ".ccmram" ) ) )
+#else
+  #define CCM_DATA
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+#include "sleep.h"
+
+// Vendor-provided device header file.
+#if defined( VVC_F3 )
+  #include "stm32f3xx.h"
+#elif defined( VVC_F4 )
+  #include "stm32f4xx.h"
+#elif defined( VVC_G0 )
+  #include "stm32g0xx.h"
+#endif
+// Project includes.
+#include "clock.h"
+#if defined( VVC_HOST )
+  #include <sched.h>
+  #include <time.h>
+#endif
+
+// TIM7 counts microseconds, and overflows every millisecond.
+// (TIM6 triggers the DAC, and SysTick is the cycle counter on
+// Cortex-M0+ cores, so TIM7 is free in every example)
+#define SLEEP_TICK_US ( 1000 )
+#if defined( VVC_F3 )
+  #define SLEEP_IRQn ( TIM7_DAC2_IRQn )
+  #define SLEEP_IRQ_handler TIM7_DAC2_IRQ_handler
+#elif defined( VVC_F4 )
+  #define SLEEP_IRQn ( TIM7_IRQn )
+  #define SLEEP_IRQ_handler TIM7_IRQ_handler
+#elif defined( VVC_G0 )
+  #define SLEEP_IRQn ( TIM7_LPTIM2_IRQn )
+  #define SLEEP_IRQ_handler TIM7_LPTIM2_IRQ_handler
+#endif
+
+// Milliseconds since 'sleep_init'.
+static volatile uint32_t sleep_ms_count = 0;
+volatile uint32_t sleep_idle_us = 0;
+// Start of the current 'sleep_idle_percent' window.
+static uint32_t sleep_window_us   = 0;
+static uint32_t sleep_window_idle = 0;
+
+// Waiting timeouts. Empty slots have no callback.
+typedef struct {
+  sleep_cb_t cb;
+  uint32_t   due;
+} sleep_timeout_t;
+static sleep_timeout_t sleep_timeouts[ SLEEP_MAX_TIMEOUTS ];
+
+#if defined( VVC_HOST )
+static struct timespec sleep_t0;
+#endif
+
+// Count one millisecond, and run any timeouts which are due.
+static void sleep_tick( void ) {
+  uint32_t now = ++sleep_ms_count;
+  for ( size_t i = 0; i < SLEEP_MAX_TIMEOUTS; ++i ) {
+    sleep_cb_t cb = sleep_timeouts[ i ].cb;
+    if ( cb && ( int32_t )( now - sleep_timeouts[ i ].due ) >= 0 ) {
+      // (Free the slot first, so the callback can re-arm itself)
+      sleep_timeouts[ i ].cb = 0;
+      cb();
+    }
+  }
+}
+
+// Start the 1MHz timer and its millisecond interrupt.
+void sleep_init( void ) {
+  sleep_ms_count = 0;
+  sleep_idle_us  = 0;
+  sleep_window_us   = 0;
+  sleep_window_idle = 0;
+  for ( size_t i = 0; i < SLEEP_MAX_TIMEOUTS; ++i ) {
+    sleep_timeouts[ i ].cb = 0;
+  }
+#if defined( VVC_HOST )
+  clock_gettime( CLOCK_MONOTONIC, &sleep_t0 );
+#else
+#if defined( VVC_G0 )
+  RCC->APBENR1 |= ( RCC_APBENR1_TIM7EN );
+#else
+  RCC->APB1ENR |= ( RCC_APB1ENR_TIM7EN );
+#endif
+  TIM7->CR1  = 0;
+  TIM7->PSC  = ( clock_tim_hz() / 1000000 ) - 1;
+  TIM7->ARR  = SLEEP_TICK_US - 1;
+  // Load the prescaler now, and clear the update flag which
+  // that sets.
+  TIM7->EGR  = ( TIM_EGR_UG );
+  TIM7->SR   = 0;
+  TIM7->DIER = ( TIM_DIER_UIE );
+  TIM7->CR1  = ( TIM_CR1_CEN );
+  NVIC_SetPriority( SLEEP_IRQn, 0x03 );
+  NVIC_EnableIRQ( SLEEP_IRQn );
+#endif
+}
+
+// Microseconds since 'sleep_init'. This wraps around after
+// about 71 minutes.
+uint32_t sleep_micros( void ) {
+#if defined( VVC_HOST )
+  // Host builds have no timer interrupt, so count milliseconds
+  // and run timeouts whenever the time is read.
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  uint64_t us = ( uint64_t )( now.tv_sec - sleep_t0.tv_sec ) * 1000000ULL +
+                ( ( uint64_t )( now.tv_nsec - sleep_t0.tv_nsec ) / 1000 );
+  while ( sleep_ms_count < ( us / SLEEP_TICK_US ) ) { sleep_tick(); }
+  return ( uint32_t )us;
+#else
+  uint32_t ms, cnt;
+  do {
+    ms  = sleep_ms_count;
+    cnt = TIM7->CNT;
+  } while ( ms != sleep_ms_count );
+  // If interrupts are masked, the counter may have wrapped
+  // without the millisecond count being updated yet.
+  if ( ( TIM7->SR & TIM_SR_UIF ) && ( cnt < ( SLEEP_TICK_US / 2 ) ) ) {
+    ++ms;
+  }
+  return ( ms * SLEEP_TICK_US ) + cnt;
+#endif
+}
+
+// Milliseconds since 'sleep_init'.
+uint32_t sleep_millis( void ) {
+#if defined( VVC_HOST )
+  sleep_micros();
+#endif
+  return sleep_ms_count;
+}
+
+// Wait for the next interrupt, and add the time spent waiting
+// to 'sleep_idle_us'. Interrupts are masked around 'WFI' so that
+// the handler which wakes the core runs after the wait has been
+// timed, and is not counted as idle time.
+void sleep_idle( void ) {
+#if defined( VVC_HOST )
+  uint32_t start = sleep_micros();
+  sched_yield();
+  sleep_idle_us += sleep_micros() - start;
+#else
+  __disable_irq();
+  uint32_t start = sleep_micros();
+  __WFI();
+  sleep_idle_us += sleep_micros() - start;
+  __enable_irq();
+#endif
+}
+
+// Wait for 'us' microseconds. The core sleeps until less than
+// one millisecond is left, then watches the timer's counter.
+void sleep_us( uint32_t us ) {
+  uint32_t start = sleep_micros();
+  while ( ( sleep_micros() - start ) + SLEEP_TICK_US < us ) {
+    sleep_idle();
+  }
+  while ( ( sleep_micros() - start ) < us ) {};
+}
+
+// Wait for 'ms' milliseconds.
+void sleep_ms( uint32_t ms ) {
+  for ( ; ms >= 1000; ms -= 1000 ) { sleep_us( 1000000 ); }
+  sleep_us( ms * 1000 );
+}
+
+// Run 'cb' from the timer interrupt after 'ms' milliseconds.
+// Returns an ID for 'sleep_cancel', or -1 if every timeout
+// slot is in use.
+int sleep_after( uint32_t ms, sleep_cb_t cb ) {
+  for ( size_t i = 0; i < SLEEP_MAX_TIMEOUTS; ++i ) {
+    if ( !sleep_timeouts[ i ].cb ) {
+      // (Set the due time first; the interrupt only checks
+      // slots which have a callback)
+      sleep_timeouts[ i ].due = sleep_ms_count + ms + 1;
+      sleep_timeouts[ i ].cb  = cb;
+      return ( int )i;
+    }
+  }
+  return -1;
+}
+
+// Stop a timeout from running, if it has not already.
+void sleep_cancel( int id ) {
+  if ( id >= 0 && id < SLEEP_MAX_TIMEOUTS ) {
+    sleep_timeouts[ id ].cb = 0;
+  }
+}
+
+// Percentage of time which the core has spent idle since the
+// last call.
+uint32_t sleep_idle_percent( void ) {
+  uint32_t now  = sleep_micros();
+  uint32_t idle = sleep_idle_us;
+  uint32_t span = now - sleep_window_us;
+  uint32_t used = idle - sleep_window_idle;
+  sleep_window_us   = now;
+  sleep_window_idle = idle;
+  if ( span < 100 ) { return 0; }
+  uint32_t pct = used / ( span / 100 );
+  return ( pct > 100 ) ? 100 : pct;
+}
+
+#if !defined( VVC_HOST )
+// TIM7 interrupt handler.
+void SLEEP_IRQ_handler( void ) {
+  if ( TIM7->SR & TIM_SR_UIF ) {
+    TIM7->SR = 0;
+    sleep_tick();
+  }
+}
+#endif
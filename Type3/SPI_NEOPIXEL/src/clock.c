@@ -0,0 +1,211 @@
+#include "clock.h"
+
+// Vendor-provided device header file.
+#if defined( VVC_F3 )
+  #include "stm32f3xx.h"
+#elif defined( VVC_F4 )
+  #include "stm32f4xx.h"
+#elif defined( VVC_G0 )
+  #include "stm32g0xx.h"
+#endif
+// Project includes.
+#include "reg.h"
+
+// Core clock speed in Hertz.
+extern uint32_t SystemCoreClock;
+
+// Internal oscillator speed, which the core starts up with, and
+// the highest APB1 bus speed. Each multiple of 'CLOCK_WS_HZ' in
+// the core clock speed needs one more flash wait state.
+// (F4 wait states are for a 2.7-3.6V supply; G0 chips have one
+// APB bus, which can run as fast as the core)
+#if defined( VVC_F3 )
+  #define CLOCK_HSI_HZ  ( 8000000 )
+  #define CLOCK_APB1_HZ ( 36000000 )
+  #define CLOCK_WS_HZ   ( 24000000 )
+#elif defined( VVC_F4 )
+  #define CLOCK_HSI_HZ  ( 16000000 )
+  #define CLOCK_APB1_HZ ( 50000000 )
+  #define CLOCK_WS_HZ   ( 25000000 )
+#elif defined( VVC_G0 )
+  #define CLOCK_HSI_HZ  ( 16000000 )
+  #define CLOCK_APB1_HZ ( 64000000 )
+  #define CLOCK_WS_HZ   ( 24000000 )
+#endif
+
+// Set the core clock to the fastest speed which the PLL can make
+// from the internal oscillator without going over 'hz', with
+// enough flash wait states and with the flash prefetch buffer and
+// caches turned on. APB1 is divided by 2 if it would be too fast.
+// Updates 'SystemCoreClock', and returns the new speed.
+// Call this once at startup, before setting up any peripherals
+// whose timing depends on the clock.
+uint32_t clock_init( uint32_t hz ) {
+  if ( hz > CLOCK_MAX_HZ ) { hz = CLOCK_MAX_HZ; }
+  // Find the PLL's multiplier and divider. ( mul = 0 means that
+  // the internal oscillator is already the closest speed)
+  uint32_t best = CLOCK_HSI_HZ;
+  uint32_t mul = 0;
+#if !defined( VVC_F3 )
+  uint32_t div = 0;
+#endif
+#if defined( VVC_F3 )
+  // HSI / 2 = 4MHz, multiplied by 2-16.
+  for ( uint32_t m = 2; m <= 16; ++m ) {
+    uint32_t out = ( CLOCK_HSI_HZ / 2 ) * m;
+    if ( out <= hz && out > best ) {
+      best = out;
+      mul  = m;
+    }
+  }
+#elif defined( VVC_F4 )
+  // HSI / 8 = 2MHz, multiplied by 'N' = 50-432 for a 100-432MHz
+  // VCO, and divided by 'P' = 2, 4, 6 or 8.
+  for ( uint32_t p = 2; p <= 8; p += 2 ) {
+    uint32_t n = ( hz * p ) / 2000000;
+    if ( n > 432 ) { n = 432; }
+    uint32_t vco = n * 2000000;
+    if ( n < 50 || vco < 100000000 || vco > 432000000 ) { continue; }
+    if ( ( vco / p ) > best ) {
+      best = vco / p;
+      mul  = n;
+      div  = p;
+    }
+  }
+#elif defined( VVC_G0 )
+  // HSI16, multiplied by 'N' = 8-86 for a 64-344MHz VCO, and
+  // divided by 'R' = 2-8.
+  for ( uint32_t r = 2; r <= 8; ++r ) {
+    uint32_t n = ( hz * r ) / CLOCK_HSI_HZ;
+    if ( n > 86 ) { n = 86; }
+    uint32_t vco = n * CLOCK_HSI_HZ;
+    if ( n < 8 || vco < 64000000 || vco > 344000000 ) { continue; }
+    if ( ( vco / r ) > best ) {
+      best = vco / r;
+      mul  = n;
+      div  = r;
+    }
+  }
+#endif
+
+  // Add flash wait states before the clock speeds up, and turn on
+  // the prefetch buffer (and the F4's 'ART' caches).
+  uint32_t latency = ( best - 1 ) / CLOCK_WS_HZ;
+#if defined( VVC_F3 )
+  REG_SET( FLASH->ACR, ( FLASH_ACR_LATENCY ),
+                       ( latency << FLASH_ACR_LATENCY_Pos |
+                         FLASH_ACR_PRFTBE ) );
+#elif defined( VVC_F4 )
+  // The regulator must be in 'scale 1' mode above 84MHz, and its
+  // mode can only change while the PLL is off.
+  RCC->APB1ENR |= ( RCC_APB1ENR_PWREN );
+  REG_SET( PWR->CR, ( PWR_CR_VOS ), ( 0x3 << PWR_CR_VOS_Pos ) );
+  REG_SET( FLASH->ACR, ( FLASH_ACR_LATENCY ),
+                       ( latency << FLASH_ACR_LATENCY_Pos |
+                         FLASH_ACR_PRFTEN |
+                         FLASH_ACR_ICEN |
+                         FLASH_ACR_DCEN ) );
+#elif defined( VVC_G0 )
+  REG_SET( FLASH->ACR, ( FLASH_ACR_LATENCY ),
+                       ( latency << FLASH_ACR_LATENCY_Pos |
+                         FLASH_ACR_PRFTEN |
+                         FLASH_ACR_ICEN ) );
+#endif
+  // Wait for the new latency to take effect.
+  while ( ( FLASH->ACR & FLASH_ACR_LATENCY ) !=
+          ( latency << FLASH_ACR_LATENCY_Pos ) ) {};
+#if !defined( VVC_G0 )
+  // Divide APB1 by 2 if it would be too fast.
+  REG_SET( RCC->CFGR, ( RCC_CFGR_PPRE1 ),
+                      ( ( ( best > CLOCK_APB1_HZ ) ? 0x4 : 0x0 )
+                        << RCC_CFGR_PPRE1_Pos ) );
+#endif
+
+  if ( mul ) {
+    // Configure the PLL, with the internal oscillator as its input.
+#if defined( VVC_F3 )
+    // (PLLSRC = 0: HSI / 2)
+    REG_SET( RCC->CFGR, ( RCC_CFGR_PLLMUL |
+                          RCC_CFGR_PLLSRC ),
+                        ( ( mul - 2 ) << RCC_CFGR_PLLMUL_Pos ) );
+#elif defined( VVC_F4 )
+    // (PLLSRC = 0: HSI. The 'Q' output only drives USB and SDIO,
+    // so it is just kept at or below 48MHz)
+    uint32_t q = ( ( mul * 2000000 ) + 47999999 ) / 48000000;
+    if ( q < 2 ) { q = 2; }
+    REG_SET( RCC->PLLCFGR, ( RCC_PLLCFGR_PLLM |
+                             RCC_PLLCFGR_PLLN |
+                             RCC_PLLCFGR_PLLP |
+                             RCC_PLLCFGR_PLLQ |
+                             RCC_PLLCFGR_PLLSRC ),
+                           ( 8 << RCC_PLLCFGR_PLLM_Pos |
+                             mul << RCC_PLLCFGR_PLLN_Pos |
+                             ( ( div / 2 ) - 1 ) << RCC_PLLCFGR_PLLP_Pos |
+                             q << RCC_PLLCFGR_PLLQ_Pos ) );
+#elif defined( VVC_G0 )
+    // (PLLSRC = 2: HSI16. M = 1)
+    REG_SET( RCC->PLLCFGR, ( RCC_PLLCFGR_PLLR |
+                             RCC_PLLCFGR_PLLREN |
+                             RCC_PLLCFGR_PLLN |
+                             RCC_PLLCFGR_PLLM |
+                             RCC_PLLCFGR_PLLSRC ),
+                           ( ( div - 1 ) << RCC_PLLCFGR_PLLR_Pos |
+                             mul << RCC_PLLCFGR_PLLN_Pos |
+                             RCC_PLLCFGR_PLLREN |
+                             2 << RCC_PLLCFGR_PLLSRC_Pos ) );
+#endif
+    // Enable and select the PLL.
+    RCC->CR   |= RCC_CR_PLLON;
+    while ( !( RCC->CR & RCC_CR_PLLRDY ) ) {};
+    REG_SET( RCC->CFGR, ( RCC_CFGR_SW ),
+                        ( 2 << RCC_CFGR_SW_Pos ) );
+    while ( ( RCC->CFGR & RCC_CFGR_SWS ) >> RCC_CFGR_SWS_Pos != 2 ) {};
+  }
+  SystemCoreClock = best;
+  return best;
+}
+
+// Divider which an APB prescaler field selects. (Values below 4
+// do not divide the clock)
+static uint32_t clock_apb_div( uint32_t ppre ) {
+  return ( ppre & 0x4 ) ? ( 2UL << ( ppre & 0x3 ) ) : 1;
+}
+
+// APB1 bus speed, in Hertz. (The AHB bus always runs at the core
+// clock speed in these examples)
+uint32_t clock_apb1_hz( void ) {
+#if defined( VVC_G0 )
+  return SystemCoreClock /
+         clock_apb_div( ( RCC->CFGR & RCC_CFGR_PPRE ) >> RCC_CFGR_PPRE_Pos );
+#else
+  return SystemCoreClock /
+         clock_apb_div( ( RCC->CFGR & RCC_CFGR_PPRE1 ) >> RCC_CFGR_PPRE1_Pos );
+#endif
+}
+
+// APB2 bus speed, in Hertz. (G0 chips only have one APB bus)
+uint32_t clock_apb2_hz( void ) {
+#if defined( VVC_G0 )
+  return clock_apb1_hz();
+#else
+  return SystemCoreClock /
+         clock_apb_div( ( RCC->CFGR & RCC_CFGR_PPRE2 ) >> RCC_CFGR_PPRE2_Pos );
+#endif
+}
+
+// Clock speed of the timers on APB1, such as TIM6 and TIM7. They
+// run at twice the bus speed when the bus is divided, which puts
+// them back at the core clock speed after a divide-by-2.
+uint32_t clock_tim_hz( void ) {
+  uint32_t pclk = clock_apb1_hz();
+  return ( pclk == SystemCoreClock ) ? pclk : ( pclk * 2 );
+}
+
+// SPI 'BR' field for the fastest bit clock which is no faster
+// than 'hz', from a bus clock of 'pclk'. (The bit clock is
+// pclk / 2 ^ ( BR + 1 ))
+uint32_t clock_spi_br( uint32_t pclk, uint32_t hz ) {
+  uint32_t br = 0;
+  while ( br < 7 && ( pclk >> ( br + 1 ) ) > hz ) { ++br; }
+  return br;
+}